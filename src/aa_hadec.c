@@ -1,24 +1,28 @@
 #include <stdio.h>
 #include <math.h>
 #include "astro.h"
+#include "ephem.h"
+
+static void aaha_aux (double lat, int n, double x[], double y[], double p[],
+                      double q[]);
 
 /* the actual formula is the same for both transformation directions so
- * do it here once for each way.
+ * do it here once for each way, over n positions at the same latitude.
+ * the loop is kept free of branches and calls other than to the math library
+ * so a compiler may vectorize it; the results are the same as one at a time.
  * N.B. all arguments are in radians.
  */
 static void
-aaha_aux (lat, x, y, p, q)
+aaha_aux (lat, n, x, y, p, q)
 double lat;
-double x, y;
-double *p, *q;
+int n;
+double x[], y[];
+double p[], q[];
 {
     static double lastlat = -1000.;
     static double sinlastlat, coslastlat;
-    double sy, cy;
-    double sx, cx;
-    double sq, cq;
-    double a;
-    double cp;
+    double sl, cl;
+    int i;
 
     /* latitude doesn't change much, so try to reuse the sin and cos evals.
      */
@@ -28,34 +32,41 @@ double *p, *q;
         coslastlat = cos (lat);
         lastlat = lat;
     }
+    sl = sinlastlat;
+    cl = coslastlat;
+
+    for (i = 0; i < n; i++)
+    {
+        double sy, cy;
+        double sx, cx;
+        double sq, cq;
+        double a;
+        double cp;
+        double pv;
 
-    sy = sin (y);
-    cy = cos (y);
-    sx = sin (x);
-    cx = cos (x);
+        sy = sin (y[i]);
+        cy = cos (y[i]);
+        sx = sin (x[i]);
+        cx = cos (x[i]);
 
-    /* define GOODATAN2 if atan2 returns full range -PI through +PI.
-     */
+        /* define GOODATAN2 if atan2 returns full range -PI through +PI.
+         */
 #ifdef GOODATAN2
-    *q = asin ((sy*sinlastlat) + (cy*coslastlat*cx));
-    *p = atan2 (-cy*sx, -cy*cx*sinlastlat + sy*coslastlat);
+        q[i] = asin ((sy*sl) + (cy*cl*cx));
+        p[i] = atan2 (-cy*sx, -cy*cx*sl + sy*cl);
 #else
 #define	EPS	(1e-20)
-    sq = (sy*sinlastlat) + (cy*coslastlat*cx);
-    *q = asin (sq);
-    cq = cos (*q);
-    a = coslastlat*cq;
-    if (a > -EPS && a < EPS)
-        a = a < 0 ? -EPS : EPS; /* avoid / 0 */
-    cp = (sy - (sinlastlat*sq))/a;
-    if (cp >= 1.0)	/* the /a can be slightly > 1 */
-        *p = 0.0;
-    else if (cp <= -1.0)
-        *p = PI;
-    else
-        *p = acos ((sy - (sinlastlat*sq))/a);
-    if (sx>0) *p = 2.0*PI - *p;
+        sq = (sy*sl) + (cy*cl*cx);
+        q[i] = asin (sq);
+        cq = cos (q[i]);
+        a = cl*cq;
+        a = a > -EPS && a < EPS ? (a < 0 ? -EPS : EPS) : a; /* avoid / 0 */
+        cp = (sy - (sl*sq))/a;
+        pv = cp >= 1.0 ? 0.0 :	/* the /a can be slightly > 1 */
+             cp <= -1.0 ? PI : acos (cp);
+        p[i] = sx>0 ? 2.0*PI - pv : pv;
 #endif
+    }
 }
 
 /* given latitude (n+, radians), lat, altitude (up+, radians), alt, and
@@ -67,7 +78,19 @@ double lat;
 double alt, az;
 double *ha, *dec;
 {
-    aaha_aux (lat, az, alt, ha, dec);
+    aaha_aux (lat, 1, &az, &alt, ha, dec);
+}
+
+/* aa_hadec() for each of the n positions alt[] and az[], into ha[] and dec[],
+ * all at the same latitude.
+ */
+void aa_hadec_n (lat, n, alt, az, ha, dec)
+double lat;
+int n;
+double alt[], az[];
+double ha[], dec[];
+{
+    aaha_aux (lat, n, az, alt, ha, dec);
 }
 
 /* given latitude (n+, radians), lat, hour angle (radians), ha, and declination
@@ -80,6 +103,17 @@ double lat;
 double ha, dec;
 double *alt, *az;
 {
-    aaha_aux (lat, ha, dec, az, alt);
+    aaha_aux (lat, 1, &ha, &dec, az, alt);
 }
 
+/* hadec_aa() for each of the n positions ha[] and dec[], into alt[] and az[],
+ * all at the same latitude.
+ */
+void hadec_aa_n (lat, n, ha, dec, alt, az)
+double lat;
+int n;
+double ha[], dec[];
+double alt[], az[];
+{
+    aaha_aux (lat, n, ha, dec, az, alt);
+}
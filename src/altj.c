@@ -1,17 +1,33 @@
 /* management and computional support for jupiter's detail menu.
+ * also a finder for the transits, occultations, shadow transits and
+ * eclipses of the Galilean moons over a span of days.
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include "astro.h"
 #include "circum.h"
 #include "screen.h"
 #include "ephem.h"
 
+#define	JM_STEP		(10./(24*60))	/* event scan step, days */
+#define	JM_NSTEP	144		/* scan steps computed at once */
+#define	JM_TMACC	(1./SPD)	/* events are refined to this, days */
+#define	JM_POLAR	0.935		/* jupiter polar/equatorial radius */
+#define	JM_MAXEV	1024		/* most events in JM_NSTEP steps */
+#define	JM_TEXTSZ	8192		/* events text written in this size */
+#define	JM_LINELEN	64		/* longest event line, with slop */
+
+static void jm_scan (double mjd0, double days, int *nevp, double *secsp);
+static double jm_refine (int k, int fromsun, int limb, double t0, double t1);
+static double jm_seen (double d);
 static void
-jupinfo (double d, double *ix, double *ex, double *gx, double *cx,
-         double *iy, double *ey, double *gy, double *cy, double *iz,
-         double *ez, double *gz, double *cz, double *sIcml, double *sIIcml);
+jupinfo (double d, int fromsun, double x[4], double y[4], double z[4],
+         double *sIcml, double *sIIcml, double *delp, double *rp);
+
+static double jm_days = 30.;	/* event scan window, days */
 
 void altj_labels()
 {
@@ -34,6 +50,7 @@ void altj_labels()
     f_string (R_JCOLHDNGS,	C_JMZ-2,	"Z (+towards)");
     f_string (R_JMAP+1,	2,		"West");
     f_string (R_JMAP+1,	NC-5,		"East");
+    f_string (R_JEVENTS,	C_JEVENTS,	"Moon events");
 }
 
 /* display jupiter's details. */
@@ -52,31 +69,31 @@ Now *np;
     } raw_ml[NJM], sorted_ml[NJM];
     int nml;	/* number of sorted_ml[] elements in use */
     char buf[NC];
-    double iy, ey, gy, cy;
-    double iz, ez, gz, cz;
-    double sIcml, sIIcml;
+    double x[4], y[4], z[4];
+    double sIcml, sIIcml, del, r;
     int i;
 
     /* compute jupiter info.
      * put moons' x loc into raw_ml[] so it can be sorted for graphic.
      */
-    jupinfo (mjd, &raw_ml[0].x, &raw_ml[1].x, &raw_ml[2].x, &raw_ml[3].x,
-             &iy, &ey, &gy, &cy, &iz, &ez, &gz, &cz, &sIcml, &sIIcml);
+    jupinfo (mjd, 0, x, y, z, &sIcml, &sIIcml, &del, &r);
+    for (i = 0; i < 4; i++)
+        raw_ml[i].x = x[i];
 
     f_double (R_JCML, C_JCMLSI, fmt, sIcml);
     f_double (R_JCML, C_JCMLSII, fmt, sIIcml);
-    f_double (R_IO, C_JMX, fmt, raw_ml[0].x);
-    f_double (R_EUROPA, C_JMX, fmt, raw_ml[1].x);
-    f_double (R_GANYMEDE, C_JMX, fmt, raw_ml[2].x);
-    f_double (R_CALLISTO, C_JMX, fmt, raw_ml[3].x);
-    f_double (R_IO, C_JMY, fmt, iy);
-    f_double (R_EUROPA, C_JMY, fmt, ey);
-    f_double (R_GANYMEDE, C_JMY, fmt, gy);
-    f_double (R_CALLISTO, C_JMY, fmt, cy);
-    f_double (R_IO, C_JMZ, fmt, iz);
-    f_double (R_EUROPA, C_JMZ, fmt, ez);
-    f_double (R_GANYMEDE, C_JMZ, fmt, gz);
-    f_double (R_CALLISTO, C_JMZ, fmt, cz);
+    f_double (R_IO, C_JMX, fmt, x[0]);
+    f_double (R_EUROPA, C_JMX, fmt, x[1]);
+    f_double (R_GANYMEDE, C_JMX, fmt, x[2]);
+    f_double (R_CALLISTO, C_JMX, fmt, x[3]);
+    f_double (R_IO, C_JMY, fmt, y[0]);
+    f_double (R_EUROPA, C_JMY, fmt, y[1]);
+    f_double (R_GANYMEDE, C_JMY, fmt, y[2]);
+    f_double (R_CALLISTO, C_JMY, fmt, y[3]);
+    f_double (R_IO, C_JMZ, fmt, z[0]);
+    f_double (R_EUROPA, C_JMZ, fmt, z[1]);
+    f_double (R_GANYMEDE, C_JMZ, fmt, z[2]);
+    f_double (R_CALLISTO, C_JMZ, fmt, z[3]);
 
     raw_ml[0].mid = 'I';
     raw_ml[1].mid = 'E';
@@ -118,27 +135,286 @@ Now *np;
     f_string (R_JMAP, C_JMAP, buf);
 }
 
+/* find the x, y, z of the Galilean moons, as from jupinfo(), at each of the
+ * n dates in d[]. the values for d[i] go in x[4*i] .. x[4*i+3], and so on,
+ * in order Io, Europa, Ganymede, Callisto.
+ * if fromsun, find them as seen from the sun, for shadows and eclipses.
+ */
+void jupmoons (d, n, fromsun, x, y, z)
+double d[];
+int n;
+int fromsun;
+double x[], y[], z[];
+{
+    double sI, sII, del, r;
+    int i;
+
+    for (i = 0; i < n; i++)
+        jupinfo (d[i], fromsun, &x[4*i], &y[4*i], &z[4*i], &sI, &sII, &del,
+                 &r);
+}
+
+/* picked Moon events on the jupiter menu:
+ * ask for the number of days to scan then append all the events of the
+ * Galilean moons from now over that many days to the listing file.
+ */
+void jm_events_setup (np)
+Now *np;
+{
+    char p[64], buf[NC];
+    double secs;
+    int nev;
+
+    (void) sprintf (p, "Jupiter moon events: days to scan <%g>: ", jm_days);
+    f_prompt (p);
+    if (read_line (buf, PW-strlen(p)) < 0)
+        return;
+    if (buf[0] != '\0')
+    {
+        double d = atof (buf);
+        if (d <= 0)
+        {
+            f_msg ("Days to scan must be positive.");
+            return;
+        }
+        jm_days = d;
+    }
+
+    print_updating();
+    jm_scan (mjd, jm_days, &nev, &secs);
+    if (nev >= 0)
+    {
+        (void) sprintf (buf,
+                        "Jupiter moon events: %d to listing file; %.2f us/epoch",
+                        nev, secs*1e6/(2*(jm_days/JM_STEP)));
+        f_prompt (buf);
+    }
+}
+
+/* one event found by jm_scan() */
+typedef struct
+{
+    double e_mjd;	/* when */
+    int e_moon;		/* 0..3 */
+    char *e_what;	/* what happened */
+} JmEvent;
+
+/* qsort compare function to put events in time order */
+static int
+jm_cmp (const void *e1, const void *e2)
+{
+    double d = ((JmEvent *)e1)->e_mjd - ((JmEvent *)e2)->e_mjd;
+    return (d < 0 ? -1 : d > 0 ? 1 : 0);
+}
+
+/* scan days from mjd0 for moon events and write them to the listing file as
+ * they are found. each step the moons are found from the earth and from the
+ * sun and checked for crossing the limb of jupiter, taking z to tell in
+ * front from behind, and, from the earth, for crossing x = 0.
+ * positions are found JM_NSTEP steps at a time with jupmoons(); the events
+ * in each such block are sorted and added to the text, which goes to the
+ * listing file whenever it fills.
+ * set *nevp to the number written, or -1 if trouble, and *secsp to the time
+ * spent finding positions.
+ */
+static void
+jm_scan (mjd0, days, nevp, secsp)
+double mjd0, days;
+int *nevp;
+double *secsp;
+{
+    static char *mnames[] = {"Io", "Europa", "Ganymede", "Callisto"};
+    static char *limbev[2][2][2] =
+    {
+        /* from earth: behind, in front; each leaving, entering the disc */
+        {   {"occultation ends", "occultation begins"},
+            {"transit ends", "transit begins"}
+        },
+        /* from sun */
+        {   {"eclipse ends", "eclipse begins"},
+            {"shadow transit ends", "shadow transit begins"}
+        }
+    };
+    /* per step and view, the 4 moons' x, y, z; [0] is the step before */
+    static double t[JM_NSTEP+1];
+    static double x[2][4*(JM_NSTEP+1)], y[2][4*(JM_NSTEP+1)];
+    static double z[2][4*(JM_NSTEP+1)];
+    static JmEvent ev[JM_MAXEV+8];	/* one step may add 8 */
+    char *text, *tp, errbuf[NC];
+    double end = mjd0 + days;
+    double tstart, dy;
+    int nt, nev, nbev, i, k, v;
+    int m, yr, h, mn, sec, neg;
+
+    *nevp = -1;
+    *secsp = 0;
+    tp = text = malloc (JM_TEXTSZ);
+    if (!text)
+    {
+        f_msg ("Jupiter moon events: no memory.");
+        return;
+    }
+
+    mjd_cal (mjd0, &m, &dy, &yr);
+    tp += sprintf (tp, "* Jupiter moon events from %d/%02d/%d for %g days\n",
+                   m, (int)dy, yr, days);
+
+    nev = 0;
+    t[0] = mjd0;
+    for (v = 0; v < 2; v++)
+        jupmoons (t, 1, v, x[v], y[v], z[v]);
+    while (t[0] < end)
+    {
+        /* positions for the next block of steps */
+        for (nt = 1; nt <= JM_NSTEP && t[nt-1] < end; nt++)
+            t[nt] = t[0] + nt*JM_STEP;
+        tstart = time_mono();
+        for (v = 0; v < 2; v++)
+            jupmoons (t+1, nt-1, v, x[v]+4, y[v]+4, z[v]+4);
+        *secsp += time_mono() - tstart;
+
+        /* look for crossings between each step and the one before */
+        nbev = 0;
+        for (i = 1; i < nt && nbev < JM_MAXEV; i++)
+            for (v = 0; v < 2; v++)
+                for (k = 0; k < 4; k++)
+                {
+                    int j = 4*i+k;
+                    double ye0 = y[v][j-4]/JM_POLAR, ye1 = y[v][j]/JM_POLAR;
+                    int in0 = x[v][j-4]*x[v][j-4] + ye0*ye0 < 1;
+                    int in1 = x[v][j]*x[v][j] + ye1*ye1 < 1;
+                    JmEvent *ep = &ev[nbev];
+
+                    if (in0 != in1)
+                    {
+                        ep->e_mjd = jm_refine (k, v, 1, t[i-1], t[i]);
+                        ep->e_what = limbev[v][z[v][j] > 0][in1];
+                        if (v == 1)
+                            ep->e_mjd += jm_seen (ep->e_mjd);
+                    }
+                    else if (v == 0 && (x[v][j-4] < 0) != (x[v][j] < 0))
+                    {
+                        ep->e_mjd = jm_refine (k, v, 0, t[i-1], t[i]);
+                        ep->e_what = z[v][j] > 0 ? "inferior conjunction"
+                                     : "superior conjunction";
+                    }
+                    else
+                        continue;
+                    ep->e_moon = k;
+                    nbev++;
+                }
+
+        /* add them to the text in time order, writing it out as it fills */
+        qsort ((char *)ev, nbev, sizeof(JmEvent), jm_cmp);
+        for (i = 0; i < nbev; i++)
+        {
+            if (tp - text > JM_TEXTSZ - JM_LINELEN)
+            {
+                if (listing_text (text, errbuf) < 0)
+                {
+                    f_msg (errbuf);
+                    free (text);
+                    return;
+                }
+                tp = text;
+            }
+            mjd_cal (mjd_day (ev[i].e_mjd), &m, &dy, &yr);
+            dec_sex (mjd_hr (ev[i].e_mjd), &h, &mn, &sec, &neg);
+            tp += sprintf (tp, "%2d/%02d/%-4d %2d:%02d:%02d  %-8s  %s\n",
+                           m, (int)dy, yr, h, mn, sec, mnames[ev[i].e_moon],
+                           ev[i].e_what);
+        }
+        nev += nbev;
+
+        /* last step becomes the step before for the next block */
+        t[0] = t[nt-1];
+        for (v = 0; v < 2; v++)
+            for (k = 0; k < 4; k++)
+            {
+                x[v][k] = x[v][4*(nt-1)+k];
+                y[v][k] = y[v][4*(nt-1)+k];
+                z[v][k] = z[v][4*(nt-1)+k];
+            }
+    }
+
+    if (tp > text && listing_text (text, errbuf) < 0)
+        f_msg (errbuf);
+    else
+        *nevp = nev;
+    free (text);
+}
+
+/* find when moon k, as seen from the earth or, if fromsun, the sun, crosses
+ * the limb of jupiter, if limb, else x = 0, between t0 and t1, by bisection
+ * to within JM_TMACC.
+ */
+static double
+jm_refine (k, fromsun, limb, t0, t1)
+int k, fromsun, limb;
+double t0, t1;
+{
+    double x[4], y[4], z[4], sI, sII, del, r;
+    double f0, f;
+
+    jupinfo (t0, fromsun, x, y, z, &sI, &sII, &del, &r);
+    f0 = limb ? x[k]*x[k] + y[k]*y[k]/(JM_POLAR*JM_POLAR) - 1 : x[k];
+    while (t1 - t0 > JM_TMACC)
+    {
+        double tm = (t0 + t1)/2;
+
+        jupinfo (tm, fromsun, x, y, z, &sI, &sII, &del, &r);
+        f = limb ? x[k]*x[k] + y[k]*y[k]/(JM_POLAR*JM_POLAR) - 1 : x[k];
+        if ((f < 0) == (f0 < 0))
+        {
+            t0 = tm;
+            f0 = f;
+        }
+        else
+            t1 = tm;
+    }
+    return ((t0 + t1)/2);
+}
+
+/* a shadow event found at d as seen from the sun is seen from the earth this
+ * many days later: the difference in light time over jupiter's distances
+ * from the earth and the sun.
+ */
+static double
+jm_seen (d)
+double d;
+{
+    double x[4], y[4], z[4], sI, sII, del, r;
+
+    jupinfo (d, 0, x, y, z, &sI, &sII, &del, &r);
+    return ((del - r)/173.);
+}
+
 #define	dsin(x)	sin(degrad(x))
 #define	dcos(x)	cos(degrad(x))
 
 /* given a modified julian date (ie, days since Jan .5 1900), d, return x, y, z
- *   location of each Galilean moon as a multiple of Jupiter's radius. on this
- *   scale, Callisto is never more than 26.5593. +x is easterly, +y is
- *   southerly, +z is towards earth. x and z are relative to the equator
- *   of Jupiter; y is further corrected for earth's position above or below
- *   this plane. also, return the system I and II central meridian longitude,
- *   in degress, relative to the true disk of jupiter and corrected for light
- *   travel time.
+ *   location of each Galilean moon as a multiple of Jupiter's radius, in
+ *   order Io, Europa, Ganymede, Callisto. on this scale, Callisto is never
+ *   more than 26.5593. +x is easterly, +y is southerly, +z is towards earth.
+ *   x and z are relative to the equator of Jupiter; y is further corrected
+ *   for earth's position above or below this plane. also, return the system
+ *   I and II central meridian longitude, in degress, relative to the true
+ *   disk of jupiter and corrected for light travel time.
+ *   if fromsun, the moons are found as seen from the sun instead, with no
+ *   phase angle, sun to jupiter light time and the sun's declination, so
+ *   x and y then locate their shadows and +z is towards the sun.
+ *   either way also return jupiter's distance from the earth, *delp, and
+ *   from the sun, *rp, in AU.
  * from "Astronomical Formulae for Calculators", 2nd ed, by Jean Meeus,
  *   Willmann-Bell, Richmond, Va., U.S.A. (c) 1982, chapters 35 and 36.
  */
 static void
-jupinfo (d, ix, ex, gx, cx, iy, ey, gy, cy, iz, ez, gz, cz, sIcml, sIIcml)
+jupinfo (d, fromsun, x, y, z, sIcml, sIIcml, delp, rp)
 double d;
-double *ix, *ex, *gx, *cx;
-double *iy, *ey, *gy, *cy;
-double *iz, *ez, *gz, *cz;
+int fromsun;
+double x[4], y[4], z[4];
 double *sIcml, *sIIcml;
+double *delp, *rp;
 {
     double A, B, Del, J, K, M, N, R, V;
     double cor_u1, cor_u2, cor_u3, cor_u4;
@@ -162,6 +438,13 @@ double *sIcml, *sIIcml;
     r = 5.20867 - 0.25192 * dcos(N) - 0.00610 * dcos(2*N);
     Del = sqrt (R*R + r*r - 2*R*r*dcos(K));
     psi = raddeg (asin (R/Del*dsin(K)));
+    *delp = Del;
+    *rp = r;
+    if (fromsun)
+    {
+        psi = 0;
+        Del = r;
+    }
 
     solc = (d - Del/173.);	/* speed of light correction */
     tmp = psi - B;
@@ -184,31 +467,31 @@ double *sIcml, *sIIcml;
     r3 = 14.9894 - 0.0227 * dcos (G);
     r4 = 26.3649 - 0.1944 * dcos (H);
 
-    *ix = -r1 * dsin (u1+cor_u1);
-    *ex = -r2 * dsin (u2+cor_u2);
-    *gx = -r3 * dsin (u3+cor_u3);
-    *cx = -r4 * dsin (u4+cor_u4);
+    x[0] = -r1 * dsin (u1+cor_u1);
+    x[1] = -r2 * dsin (u2+cor_u2);
+    x[2] = -r3 * dsin (u3+cor_u3);
+    x[3] = -r4 * dsin (u4+cor_u4);
 
     lam = 238.05 + 0.083091*d + 0.33*dsin(V) + B;
     Ds = 3.07*dsin(lam + 44.5);
     De = Ds - 2.15*dsin(psi)*dcos(lam+24.)
          - 1.31*(r-Del)/Del*dsin(lam-99.4);
-    dsinDe = dsin(De);
+    dsinDe = dsin(fromsun ? Ds : De);
 
     z1 = r1 * dcos(u1+cor_u1);
     z2 = r2 * dcos(u2+cor_u2);
     z3 = r3 * dcos(u3+cor_u3);
     z4 = r4 * dcos(u4+cor_u4);
 
-    *iy = z1*dsinDe;
-    *ey = z2*dsinDe;
-    *gy = z3*dsinDe;
-    *cy = z4*dsinDe;
+    y[0] = z1*dsinDe;
+    y[1] = z2*dsinDe;
+    y[2] = z3*dsinDe;
+    y[3] = z4*dsinDe;
 
-    *iz = z1;
-    *ez = z2;
-    *gz = z3;
-    *cz = z4;
+    z[0] = z1;
+    z[1] = z2;
+    z[2] = z3;
+    z[3] = z4;
 
     *sIcml  = 268.28 + 877.8169088*(d - Del/173) + psi - B;
     range (sIcml, 360.0);
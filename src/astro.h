@@ -2,13 +2,20 @@
 #define	PI		3.141592653589793
 #endif
 
-/* conversions among hours (of ra), degrees and radians. */
-#define	degrad(x)	((x)*PI/180.)
-#define	raddeg(x)	((x)*180./PI)
+/* conversions among hours (of ra), degrees and radians.
+ * each is one multiply by a factor the compiler folds to a constant; written
+ * as (x)*PI/180. it would have to multiply and then divide every time.
+ */
+#define	DEGRAD		(PI/180.)	/* radians per degree */
+#define	RADDEG		(180./PI)	/* degrees per radian */
+#define	HRRAD		(PI/12.)	/* radians per hour */
+#define	RADHR		(12./PI)	/* hours per radian */
+#define	degrad(x)	((x)*DEGRAD)
+#define	raddeg(x)	((x)*RADDEG)
 #define	hrdeg(x)	((x)*15.)
-#define	deghr(x)	((x)/15.)
-#define	hrrad(x)	degrad(hrdeg(x))
-#define	radhr(x)	deghr(raddeg(x))
+#define	deghr(x)	((x)*(1./15.))
+#define	hrrad(x)	((x)*HRRAD)
+#define	radhr(x)	((x)*RADHR)
 
 /* ratio of from synodic (solar) to sidereal (stellar) rate */
 #define	SIDRATE		.9972695677
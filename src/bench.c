@@ -0,0 +1,161 @@
+/* time the coordinate conversions one position at a time against their
+ * array forms, and check that both give exactly the same answers.
+ * built and run by "make bench"; not part of ephem.
+ * exits 1 if any answer differs in any bit.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "astro.h"
+#include "ephem.h"
+
+#define	NPOS	100000		/* positions per run */
+#define	NREP	10		/* runs of each form timed */
+
+static double x[NPOS], y[NPOS];		/* the inputs */
+static double p1[NPOS], q1[NPOS];	/* answers one at a time */
+static double p2[NPOS], q2[NPOS];	/* answers from the array form */
+
+static double bn_now (void);
+static int bn_diffs (void);
+static void bn_report (char *name, double t1, double t2);
+static void bn_conv (char *name,
+                     void (*f1)(double, double, double, double *, double *),
+                     void (*fn)(double, int, double [], double [], double [],
+                                double []), double a);
+static void bn_precess (double mjd1, double mjd2);
+
+static int ndiffs;		/* total answers that differ */
+
+int main ()
+{
+    double e1900, e1950, e2000, e2050;
+    int i;
+
+    /* fixed random positions, plus the poles and the equator */
+    srand (1);
+    for (i = 0; i < NPOS; i++)
+    {
+        x[i] = rand()/(double)RAND_MAX*2*PI;
+        y[i] = (rand()/(double)RAND_MAX - 0.5)*PI;
+    }
+    x[0] = 0;
+    y[0] = PI/2;
+    x[1] = PI;
+    y[1] = -PI/2;
+    x[2] = PI/2;
+    y[2] = 0;
+
+    (void) printf ("%-22s %12s %12s %8s\n", "ns/position", "one at a time",
+                   "array", "diffs");
+    bn_conv ("eq_ecl", eq_ecl, eq_ecl_n, 40000.3);
+    bn_conv ("ecl_eq", ecl_eq, ecl_eq_n, 40000.3);
+    bn_conv ("hadec_aa", hadec_aa, hadec_aa_n, 0.7);
+    bn_conv ("aa_hadec", aa_hadec, aa_hadec_n, 0.7);
+
+    year_mjd (1900.0, &e1900);
+    year_mjd (1950.0, &e1950);
+    year_mjd (2000.0, &e2000);
+    year_mjd (2050.0, &e2050);
+    bn_precess (e1950, e2000);
+    bn_precess (e2000, e2050);
+    bn_precess (e1900, e1950);
+    bn_precess (e2000, e2000);
+
+    if (ndiffs)
+    {
+        (void) printf ("%d answers differ\n", ndiffs);
+        return (1);
+    }
+    return (0);
+}
+
+/* seconds from a steady clock */
+static double
+bn_now ()
+{
+    struct timespec ts;
+
+    (void) clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec + ts.tv_nsec*1e-9);
+}
+
+/* count the answers in p2/q2 that are not bit for bit those in p1/q1 */
+static int
+bn_diffs ()
+{
+    int i, n = 0;
+
+    for (i = 0; i < NPOS; i++)
+        if (memcmp (&p1[i], &p2[i], sizeof(double))
+                || memcmp (&q1[i], &q2[i], sizeof(double)))
+            n++;
+    ndiffs += n;
+    return (n);
+}
+
+/* print one line for name, with times t1 and t2 in seconds per run */
+static void
+bn_report (name, t1, t2)
+char *name;
+double t1, t2;
+{
+    (void) printf ("%-22s %12.1f %12.1f %8d\n", name, t1/NPOS*1e9,
+                   t2/NPOS*1e9, bn_diffs());
+}
+
+/* time f1, once per position, against fn, over them all, each given a */
+static void
+bn_conv (name, f1, fn, a)
+char *name;
+void (*f1)(double, double, double, double *, double *);
+void (*fn)(double, int, double [], double [], double [], double []);
+double a;
+{
+    double t0, t1, t2;
+    int r, i;
+
+    t0 = bn_now();
+    for (r = 0; r < NREP; r++)
+        for (i = 0; i < NPOS; i++)
+            (*f1) (a, x[i], y[i], &p1[i], &q1[i]);
+    t1 = bn_now();
+    for (r = 0; r < NREP; r++)
+        (*fn) (a, NPOS, x, y, p2, q2);
+    t2 = bn_now();
+    bn_report (name, (t1-t0)/NREP, (t2-t1)/NREP);
+}
+
+/* time precess() against precess_n() from mjd1 to mjd2. both work in
+ * place, so each run starts again from x and y.
+ */
+static void
+bn_precess (mjd1, mjd2)
+double mjd1, mjd2;
+{
+    char name[64];
+    double y1, y2, t1 = 0, t2 = 0, t0;
+    int r, i;
+
+    for (r = 0; r < NREP; r++)
+    {
+        (void) memcpy (p1, x, sizeof(x));
+        (void) memcpy (q1, y, sizeof(y));
+        (void) memcpy (p2, x, sizeof(x));
+        (void) memcpy (q2, y, sizeof(y));
+        t0 = bn_now();
+        for (i = 0; i < NPOS; i++)
+            precess (mjd1, mjd2, &p1[i], &q1[i]);
+        t1 += bn_now() - t0;
+        t0 = bn_now();
+        precess_n (mjd1, mjd2, NPOS, p2, q2);
+        t2 += bn_now() - t0;
+    }
+    mjd_year (mjd1, &y1);
+    mjd_year (mjd2, &y2);
+    (void) sprintf (name, "precess %g->%g", y1, y2);
+    bn_report (name, t1/NREP, t2/NREP);
+}
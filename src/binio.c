@@ -0,0 +1,570 @@
+/* code to read and write the packed binary plot and listing files.
+ * see binio.h for the format.
+ *
+ * all i/o goes through a private staging buffer so each value costs a few
+ * byte stores rather than a stdio call, and the file itself sees only
+ * large writes. values are always written little-endian, regardless of
+ * the host, so files may be moved between machines.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "binio.h"
+
+#ifdef VMS
+#include <perror.h>
+#include <errno.h>
+#define	errsys	(sys_errlist[errno]) // ?
+#else
+#include <errno.h>
+#define	errsys	(strerror(errno))
+#endif
+
+#ifdef USE_ZLIB
+#define	NFMTS	3
+#else
+#define	NFMTS	2
+#endif
+
+static int bf_sniff (char *fn);
+static int bf_header (BinFile *bp, char *fn, char *kind, char *errbuf);
+static void bf_flush (BinFile *bp);
+static int bf_getb (BinFile *bp);
+
+/* return the format to offer after fmt; BIN_GZIP only if we can do it. */
+int bin_nextfmt (fmt)
+int fmt;
+{
+    return ((fmt + 1) % NFMTS);
+}
+
+/* return a popup menu label for the given format. */
+char *bin_fmtname (fmt)
+int fmt;
+{
+    switch (fmt)
+    {
+    case BIN_PACKED:
+        return ("Binary format");
+    case BIN_GZIP:
+        return ("Gzip format");
+    default:
+        return ("Text format");
+    }
+}
+
+/* return the format fn is in, BIN_TEXT, BIN_PACKED or BIN_GZIP, or -1 if
+ * it can not be read at all.
+ */
+int bin_format (fn)
+char *fn;
+{
+    return (bf_sniff (fn));
+}
+
+/* open fn for writing binary records of the given kind.
+ * optype is "w" to start a new file or "a" to add to an existing one; the
+ * header, naming each of the nfields fields, is only written to a new file.
+ * gz is set to write gzip framed.
+ * return a new BinFile, or 0 with a reason in errbuf.
+ */
+BinFile *bin_create (fn, optype, gz, kind, nfields, names, errbuf)
+char *fn;
+char *optype;
+int gz;
+char *kind;
+int nfields;
+char **names;
+char *errbuf;
+{
+    BinFile *bp;
+    int isnew = 1;
+    int i;
+
+    if (*optype == 'a')
+    {
+        int fmt = bf_sniff (fn);
+        if (fmt >= 0)
+        {
+            if (fmt != (gz ? BIN_GZIP : BIN_PACKED))
+            {
+                (void) sprintf (errbuf, "can not append to %s: not %s",
+                                fn, bin_fmtname (gz ? BIN_GZIP : BIN_PACKED));
+                return ((BinFile *)0);
+            }
+            isnew = 0;
+        }
+    }
+
+    bp = (BinFile *) calloc (1, sizeof(BinFile));
+    if (bp)
+        bp->bf_buf = (unsigned char *) malloc (BIN_BUFSZ);
+    if (!bp || !bp->bf_buf)
+    {
+        (void) sprintf (errbuf, "no memory for %s", fn);
+        if (bp)
+            free ((char *)bp);
+        return ((BinFile *)0);
+    }
+    bp->bf_writing = 1;
+
+#ifdef USE_ZLIB
+    if (gz)
+        bp->bf_gz = (void *) gzopen (fn, isnew ? "wb" : "ab");
+    else
+#endif
+        bp->bf_fp = fopen (fn, isnew ? "wb" : "ab");
+    if (!bp->bf_fp && !bp->bf_gz)
+    {
+        (void) sprintf (errbuf, "can not open %s: %s", fn, errsys);
+        free ((char *)bp->bf_buf);
+        free ((char *)bp);
+        return ((BinFile *)0);
+    }
+
+    if (isnew)
+    {
+        char line[128];
+
+        (void) sprintf (line, "%s %d %s\n", BIN_MAGIC, BIN_VERSION, kind);
+        for (i = 0; i <= nfields; i++)
+        {
+            int l;
+            if (i > 0)
+                (void) sprintf (line, "field %.100s\n", names[i-1]);
+            l = strlen (line);
+            if (bp->bf_n + l > BIN_BUFSZ)
+                bf_flush (bp);
+            (void) memcpy (bp->bf_buf + bp->bf_n, line, l);
+            bp->bf_n += l;
+        }
+        (void) strcpy (line, "data\n");
+        if (bp->bf_n + 5 > BIN_BUFSZ)
+            bf_flush (bp);
+        (void) memcpy (bp->bf_buf + bp->bf_n, line, 5);
+        bp->bf_n += 5;
+    }
+
+    return (bp);
+}
+
+/* add a record with the given tag and n double values. */
+void bin_rec (bp, tag, n, v)
+BinFile *bp;
+int tag;
+int n;
+double *v;
+{
+    unsigned char *p;
+    int i, j;
+
+    if (n > BIN_MAXN)
+        n = BIN_MAXN;
+    if (bp->bf_n + 3 > BIN_BUFSZ)
+        bf_flush (bp);
+    p = bp->bf_buf + bp->bf_n;
+    p[0] = tag;
+    p[1] = n & 0xff;
+    p[2] = (n >> 8) & 0xff;
+    bp->bf_n += 3;
+
+    for (i = 0; i < n; i++)
+    {
+        union
+        {
+            double d;
+            unsigned long long u;
+        } x;
+
+        if (bp->bf_n + 8 > BIN_BUFSZ)
+            bf_flush (bp);
+        p = bp->bf_buf + bp->bf_n;
+        x.d = v[i];
+        for (j = 0; j < 8; j++)
+        {
+            p[j] = (unsigned char)(x.u & 0xff);
+            x.u >>= 8;
+        }
+        bp->bf_n += 8;
+    }
+}
+
+/* add text, such as a title or a report, as text records, one for each
+ * line so a long report is not cut off at BIN_MAXN bytes and readers may
+ * take it a line at a time. a line longer than BIN_MAXN gets several.
+ */
+void bin_text (bp, text)
+BinFile *bp;
+char *text;
+{
+    do
+    {
+        char *nl = strchr (text, '\n');
+        int n = nl ? nl - text + 1 : strlen (text);
+        int i;
+
+        if (n > BIN_MAXN)
+            n = BIN_MAXN;
+        if (bp->bf_n + 3 > BIN_BUFSZ)
+            bf_flush (bp);
+        bp->bf_buf[bp->bf_n++] = '*';
+        bp->bf_buf[bp->bf_n++] = n & 0xff;
+        bp->bf_buf[bp->bf_n++] = (n >> 8) & 0xff;
+        for (i = 0; i < n; i++)
+        {
+            if (bp->bf_n == BIN_BUFSZ)
+                bf_flush (bp);
+            bp->bf_buf[bp->bf_n++] = text[i];
+        }
+        text += n;
+    }
+    while (*text);
+}
+
+/* flush and close bp and free its storage.
+ * return 0 if all went well, else -1.
+ */
+int bin_close (bp)
+BinFile *bp;
+{
+    int s = 0;
+
+    if (bp->bf_writing)
+        bf_flush (bp);
+#ifdef USE_ZLIB
+    if (bp->bf_gz)
+        s = gzclose ((gzFile)bp->bf_gz) == Z_OK ? 0 : -1;
+    else
+#endif
+    {
+        if (ferror (bp->bf_fp))
+            s = -1;
+        if (fclose (bp->bf_fp) != 0)
+            s = -1;
+    }
+    free ((char *)bp->bf_buf);
+    free ((char *)bp);
+    return (s);
+}
+
+/* open fn to read binary records, checking it holds the given kind.
+ * return a new BinFile positioned at the first record, or 0 with a reason
+ * in errbuf.
+ */
+BinFile *bin_open (fn, kind, errbuf)
+char *fn;
+char *kind;
+char *errbuf;
+{
+    BinFile *bp;
+
+#ifndef USE_ZLIB
+    if (bf_sniff (fn) == BIN_GZIP)
+    {
+        (void) sprintf (errbuf, "%s is compressed; rebuild with -DUSE_ZLIB",
+                        fn);
+        return ((BinFile *)0);
+    }
+#endif
+
+    bp = (BinFile *) calloc (1, sizeof(BinFile));
+    if (bp)
+        bp->bf_buf = (unsigned char *) malloc (BIN_BUFSZ);
+    if (!bp || !bp->bf_buf)
+    {
+        (void) sprintf (errbuf, "no memory for %s", fn);
+        if (bp)
+            free ((char *)bp);
+        return ((BinFile *)0);
+    }
+
+    /* gzopen reads uncompressed files as is */
+#ifdef USE_ZLIB
+    bp->bf_gz = (void *) gzopen (fn, "rb");
+#else
+    bp->bf_fp = fopen (fn, "rb");
+#endif
+    if (!bp->bf_fp && !bp->bf_gz)
+    {
+        (void) sprintf (errbuf, "can not open %s: %s", fn, errsys);
+        free ((char *)bp->bf_buf);
+        free ((char *)bp);
+        return ((BinFile *)0);
+    }
+
+    if (bf_header (bp, fn, kind, errbuf) < 0)
+    {
+        (void) bin_close (bp);
+        return ((BinFile *)0);
+    }
+    return (bp);
+}
+
+/* read the next record from bp.
+ * put its tag in *tagp. if it is a text record ('*') copy up to maxtxt-1
+ * bytes of it to txt and add a '\0', else copy up to maxv values to v[].
+ * return the number of values or bytes so stored, or -1 at the end of the
+ * file (or the end of a truncated record).
+ */
+int bin_next (bp, tagp, v, maxv, txt, maxtxt)
+BinFile *bp;
+int *tagp;
+double *v;
+int maxv;
+char *txt;
+int maxtxt;
+{
+    int tag, n, lo, hi;
+    int i, j, c;
+    int nstored = 0;
+
+    if ((tag = bf_getb (bp)) < 0 || (lo = bf_getb (bp)) < 0
+            || (hi = bf_getb (bp)) < 0)
+        return (-1);
+    n = lo | (hi << 8);
+    *tagp = tag;
+
+    if (tag == '*')
+    {
+        for (i = 0; i < n; i++)
+        {
+            if ((c = bf_getb (bp)) < 0)
+                return (-1);
+            if (nstored < maxtxt-1)
+                txt[nstored++] = c;
+        }
+        if (maxtxt > 0)
+            txt[nstored] = '\0';
+        return (nstored);
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        union
+        {
+            double d;
+            unsigned long long u;
+        } x;
+
+        x.u = 0;
+        for (j = 0; j < 8; j++)
+        {
+            if ((c = bf_getb (bp)) < 0)
+                return (-1);
+            x.u |= (unsigned long long)c << (8*j);
+        }
+        if (nstored < maxv)
+            v[nstored++] = x.d;
+    }
+    return (nstored);
+}
+
+/* reposition bp at its first record.
+ * return 0 if ok, else -1.
+ */
+int bin_rewind (bp)
+BinFile *bp;
+{
+    char errbuf[128];
+
+#ifdef USE_ZLIB
+    if (gzrewind ((gzFile)bp->bf_gz) < 0)
+        return (-1);
+#else
+    rewind (bp->bf_fp);
+#endif
+    bp->bf_n = bp->bf_i = 0;
+    return (bf_header (bp, "", (char *)0, errbuf));
+}
+
+/* given a whole binary file of len bytes in memory at base, such as from
+ * mmap(2), return the offset of its first record, or -1 if it is not an
+ * uncompressed binary file.
+ */
+long bin_memdata (base, len)
+unsigned char *base;
+long len;
+{
+    static char data[] = "\ndata\n";
+    long l = sizeof(BIN_MAGIC)-1;
+    long i;
+
+    if (len < l || strncmp ((char *)base, BIN_MAGIC, l))
+        return (-1);
+    for (i = l; i + sizeof(data)-1 <= len; i++)
+        if (base[i] == '\n' && !strncmp ((char *)base+i, data,sizeof(data)-1))
+            return (i + sizeof(data)-1);
+    return (-1);
+}
+
+/* decode the record at *offp in the in-memory binary file at base, len,
+ * and advance *offp past it.
+ * put its tag in *tagp and up to maxv of its double values in v[]; text
+ * records are just skipped over.
+ * return the number of values stored, or -1 at the end of the data.
+ */
+int bin_memnext (base, len, offp, tagp, v, maxv)
+unsigned char *base;
+long len;
+long *offp;
+int *tagp;
+double *v;
+int maxv;
+{
+    unsigned char *p = base + *offp;
+    long n, end;
+    int i, j;
+
+    if (*offp + 3 > len)
+        return (-1);
+    n = p[1] | (p[2] << 8);
+    *tagp = p[0];
+    end = *offp + 3 + (p[0] == '*' ? n : 8*n);
+    if (end > len)
+        return (-1);
+    *offp = end;
+    if (p[0] == '*')
+        return (0);
+
+    if (n > maxv)
+        n = maxv;
+    for (p += 3, i = 0; i < n; i++, p += 8)
+    {
+        union
+        {
+            double d;
+            unsigned long long u;
+        } x;
+
+        x.u = 0;
+        for (j = 8; --j >= 0; )
+            x.u = (x.u << 8) | p[j];
+        v[i] = x.d;
+    }
+    return (n);
+}
+
+/* peek at the first bytes of fn and return which format it is in, or -1
+ * if it can not be opened.
+ */
+static int
+bf_sniff (fn)
+char *fn;
+{
+    char buf[sizeof(BIN_MAGIC)];
+    FILE *fp;
+    int n;
+
+    fp = fopen (fn, "rb");
+    if (!fp)
+        return (-1);
+    n = fread (buf, 1, sizeof(BIN_MAGIC)-1, fp);
+    (void) fclose (fp);
+
+    if (n >= 2 && (buf[0] & 0xff) == 0x1f && (buf[1] & 0xff) == 0x8b)
+        return (BIN_GZIP);
+    if (n == sizeof(BIN_MAGIC)-1 && !strncmp (buf, BIN_MAGIC, n))
+        return (BIN_PACKED);
+    return (BIN_TEXT);
+}
+
+/* read the header lines of bp, through "data".
+ * if kind is not 0, insist the file is of that kind.
+ * return 0 if ok, else -1 with a reason in errbuf.
+ */
+static int
+bf_header (bp, fn, kind, errbuf)
+BinFile *bp;
+char *fn;
+char *kind;
+char *errbuf;
+{
+    char line[128];
+    char fkind[32];
+    int version;
+    int first = 1;
+
+    while (1)
+    {
+        int n = 0, c;
+
+        while ((c = bf_getb (bp)) >= 0 && c != '\n')
+            if (n < sizeof(line)-1)
+                line[n++] = c;
+        line[n] = '\0';
+        if (c < 0)
+        {
+            (void) sprintf (errbuf, "%s: no data in binary file", fn);
+            return (-1);
+        }
+
+        if (first)
+        {
+            if (sscanf (line, "EPHEMBIN %d %31s", &version, fkind) != 2)
+            {
+                (void) sprintf (errbuf, "%s is not a binary %s file", fn,
+                                kind ? kind : "ephem");
+                return (-1);
+            }
+            if (version > BIN_VERSION)
+            {
+                (void) sprintf (errbuf, "%s: binary version %d is too new",
+                                fn, version);
+                return (-1);
+            }
+            if (kind && strcmp (kind, fkind))
+            {
+                (void) sprintf (errbuf, "%s is a %s file, not a %s file",
+                                fn, fkind, kind);
+                return (-1);
+            }
+            first = 0;
+        }
+        else if (!strcmp (line, "data"))
+            return (0);
+    }
+}
+
+/* write out whatever is in the staging buffer. */
+static void
+bf_flush (bp)
+BinFile *bp;
+{
+    if (bp->bf_n > 0)
+    {
+#ifdef USE_ZLIB
+        if (bp->bf_gz)
+            (void) gzwrite ((gzFile)bp->bf_gz, bp->bf_buf, bp->bf_n);
+        else
+#endif
+            (void) fwrite (bp->bf_buf, 1, bp->bf_n, bp->bf_fp);
+    }
+    bp->bf_n = 0;
+}
+
+/* return the next byte from bp, or -1 at eof. */
+static int
+bf_getb (bp)
+BinFile *bp;
+{
+    if (bp->bf_i == bp->bf_n)
+    {
+        int n;
+#ifdef USE_ZLIB
+        if (bp->bf_gz)
+            n = gzread ((gzFile)bp->bf_gz, bp->bf_buf, BIN_BUFSZ);
+        else
+#endif
+            n = fread (bp->bf_buf, 1, BIN_BUFSZ, bp->bf_fp);
+        if (n <= 0)
+            return (-1);
+        bp->bf_n = n;
+        bp->bf_i = 0;
+    }
+    return (bp->bf_buf[bp->bf_i++]);
+}
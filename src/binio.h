@@ -0,0 +1,54 @@
+#ifndef _BINIO_H
+#define _BINIO_H
+
+/* packed binary plot and listing files.
+ *
+ * a binary file begins with a few text lines so it may be identified with
+ * head(1):
+ *   EPHEMBIN 1 <kind>		kind is "plot" or "list"
+ *   field <name>		one for each field, in record order
+ *   data
+ * after which come records, each of which is
+ *   1 byte tag, 2 byte little-endian count n, then n values.
+ * for tag '*' the values are n bytes of text, such as a title or one line of
+ * a report; for any other tag they are n little-endian IEEE doubles. plot
+ * records use the line label, never '*', as tag; listing records use 'L'
+ * and hold a NaN for any field that had no value. since records describe
+ * themselves, more may simply be appended to an existing file.
+ * if built with -DUSE_ZLIB the whole file may also be gzip framed.
+ */
+
+#define	BIN_MAGIC	"EPHEMBIN"	/* first word of every binary file */
+#define	BIN_VERSION	1
+#define	BIN_BUFSZ	65536		/* staging buffer size, bytes */
+#define	BIN_MAXN	65535		/* max values in one record */
+
+/* output formats, as cycled by bin_nextfmt() */
+#define	BIN_TEXT	0		/* the original %g text lines */
+#define	BIN_PACKED	1		/* packed binary records */
+#define	BIN_GZIP	2		/* packed binary, gzip framed */
+
+typedef struct
+{
+    FILE *bf_fp;		/* the file, if not compressed */
+    void *bf_gz;		/* gzFile, if compressed */
+    int bf_writing;		/* set when open for writing */
+    unsigned char *bf_buf;	/* staging buffer, BIN_BUFSZ bytes */
+    int bf_n;			/* bytes in bf_buf */
+    int bf_i;			/* next byte to read from bf_buf */
+} BinFile;
+
+int bin_nextfmt(int);
+char *bin_fmtname(int);
+int bin_format(char *);
+BinFile *bin_create(char *, char *, int, char *, int, char **, char *);
+void bin_rec(BinFile *, int, int, double *);
+void bin_text(BinFile *, char *);
+int bin_close(BinFile *);
+BinFile *bin_open(char *, char *, char *);
+int bin_next(BinFile *, int *, double *, int, char *, int);
+int bin_rewind(BinFile *);
+long bin_memdata(unsigned char *, long);
+int bin_memnext(unsigned char *, long, long *, int *, double *, int);
+
+#endif /* _BINIO_H */
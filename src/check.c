@@ -0,0 +1,114 @@
+/* print what body_cir(), riset_cir(), twilight_cir() and twilight_table()
+ * find for many dates at a few sites, for "make check" to compare with
+ * check.ref. any change to the numbers, as from a change to astro.h or to
+ * how things are computed, shows up as a difference; if it is meant, make
+ * a new check.ref with "./ephem_check > src/check.ref".
+ * not part of ephem: the few things the rest of ephem wants from main.c are
+ * stubbed out below.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "astro.h"
+#include "circum.h"
+#include "screen.h"
+#include "ephem.h"
+
+#define	NDATES	40	/* dates at each site */
+#define	NTWI	3	/* days from each twilight_table() */
+
+static double sites[][3] =	/* lat, long, rads; tz, hrs behind utc */
+{
+    {0.7, -1.3, 5},	/* northern mid latitude */
+    {-0.6, 2.5, -10},	/* southern mid latitude */
+    {1.25, 0.1, 0},	/* far enough north for midnight sun and polar night */
+};
+#define	NSITES	(sizeof(sites)/sizeof(sites[0]))
+
+static void ck_date (Now *np);
+
+int main ()
+{
+    Now n;
+    double e2000;
+    int s, k;
+
+    year_mjd (2000.0, &e2000);
+    for (s = 0; s < NSITES; s++)
+        for (k = 0; k < NDATES; k++)
+        {
+            /* 1850 to 2150, at a different time of day each time */
+            n.n_mjd = -18000.0 + k*2737.37 + s*0.31;
+            n.n_lat = sites[s][0];
+            n.n_lng = sites[s][1];
+            n.n_tz = sites[s][2];
+            n.n_temp = 10;
+            n.n_pressure = 1010;
+            n.n_height = 0;
+            n.n_epoch = (k&1) ? EOD : e2000;
+            n.n_tznm[0] = '\0';
+            (void) printf ("date %d %d %.10g\n", s, k, n.n_mjd);
+            ck_date (&n);
+        }
+    return (0);
+}
+
+/* print one line for each thing found at np */
+static void
+ck_date (np)
+Now *np;
+{
+    Twilight tw[NTWI];
+    double r, st, tt, azr, azs, altt;
+    int p, status, d, w;
+    Sky s;
+
+    for (p = MERCURY; p <= MOON; p++)
+    {
+        if (body_cir (p, 0.0, np, &s) < 0)
+            continue;
+        (void) printf ("sky %d %.10g %.10g %.10g %.10g %.10g %.10g %.10g",
+                       p, s.s_ra, s.s_dec, s.s_az, s.s_alt, s.s_sdist,
+                       s.s_edist, s.s_elong);
+        (void) printf (" %.10g %.10g %.10g\n", s.s_size, s.s_phase, s.s_mag);
+    }
+
+    for (p = MERCURY; p <= MOON; p++)
+    {
+        riset_cir (p, np, 0, p == MOON ? ADPHZN : STDHZN, &r, &st, &tt,
+                   &azr, &azs, &altt, &status);
+        (void) printf ("riset %d %#x", p, status);
+        if (!(status & (RS_ERROR|RS_NEVERUP|RS_CIRCUMPOLAR|RS_NORISE)))
+            (void) printf (" rise %.10g %.10g", r, azr);
+        if (!(status & (RS_ERROR|RS_NEVERUP|RS_CIRCUMPOLAR|RS_NOSET)))
+            (void) printf (" set %.10g %.10g", st, azs);
+        if (!(status & (RS_ERROR|RS_NEVERUP|RS_NOTRANS)))
+            (void) printf (" transit %.10g %.10g", tt, altt);
+        (void) printf ("\n");
+    }
+
+    (void) twilight_cir (np, &r, &st, &status);
+    (void) printf ("twilight %#x", status);
+    if (!status)
+        (void) printf (" %.10g %.10g", r, st);
+    (void) printf ("\n");
+
+    twilight_table (np, NTWI, tw);
+    for (d = 0; d < NTWI; d++)
+        for (w = 0; w < TW_N; w++)
+        {
+            (void) printf ("twtable %d %d %#x", d, w, tw[d].w_status[w]);
+            if (!tw[d].w_status[w])
+                (void) printf (" %.10g %.10g", tw[d].w_dawn[w],
+                               tw[d].w_dusk[w]);
+            (void) printf ("\n");
+        }
+}
+
+/* what the rest of ephem wants from main.c */
+void bye() { exit (0); }
+int chk_event() { return (-1); }
+void chk_winch() {}
+void print_updating() {}
+void redraw_screen (how_much) int how_much; {}
+void slp_sync() {}
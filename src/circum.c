@@ -51,12 +51,17 @@ Sky *sp;
     Last *lp;
     int new;
 
+    PROF_IN(PF_BODYCIR);
     switch (p)
     {
     case SUN:
-        return (sun_cir (as, np, sp));
+        new = sun_cir (as, np, sp);
+        PROF_OUT(PF_BODYCIR);
+        return (new);
     case MOON:
-        return (moon_cir (as, np, sp));
+        new = moon_cir (as, np, sp);
+        PROF_OUT(PF_BODYCIR);
+        return (new);
     case OBJX:
         lp = &objxlast;
         break;
@@ -145,6 +150,7 @@ Sky *sp;
     sp->s_alt = alt;
     sp->s_az = az;
     lp->l_sky = *sp;
+    PROF_OUT(PF_BODYCIR);
     return (new);
 }
 
@@ -13,6 +13,8 @@
 #define	STDHZN		0	/* rise/set times based on nominal conditions */
 #define	ADPHZN		1	/* rise/set times based on exact current " */
 #define	TWILIGHT	2	/* rise/set times for sun 18 degs below hor */
+#define	NAUTTWI		3	/* rise/set times for sun 12 degs below hor */
+#define	CIVILTWI	4	/* rise/set times for sun 6 degs below hor */
 
 /* info about our local observing circumstances */
 typedef struct
@@ -50,6 +52,21 @@ typedef struct
     double s_mag;	/* visual magnitude */
 } Sky;
 
+/* the twilights of one local day, as from twilight_table().
+ * each is indexed by one of the TW_* defines.
+ */
+#define	TW_ASTRO	0	/* sun 18 degs below horizon */
+#define	TW_NAUT		1	/* sun 12 degs below horizon */
+#define	TW_CIVIL	2	/* sun 6 degs below horizon */
+#define	TW_N		3	/* number of kinds of twilight */
+typedef struct
+{
+    double w_lday;		/* local day, as the mjd of its midnight */
+    double w_dawn[TW_N];	/* local hours of dawn */
+    double w_dusk[TW_N];	/* local hours of dusk */
+    int w_status[TW_N];		/* RS_* flags; times good only if 0 */
+} Twilight;
+
 /* flags for riset_cir() status */
 #define	RS_NORISE	0x001	/* object does not rise as such today */
 #define	RS_2RISES	0x002	/* object rises more than once today */
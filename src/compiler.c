@@ -142,12 +142,14 @@ char *errbuf;
 {
     int s;
 
+    PROF_IN(PF_EXPR);
     err_msg = errbuf;
     sp = stack + MAX_STACK;	/* grows towards lower addresses */
     pc = program;
     s = execute(vp);
     if (s < 0)
         good_prog = 0;
+    PROF_OUT(PF_EXPR);
     return (s);
 }
 
@@ -2,13 +2,18 @@
 #define _EPHEM_H
 
 /* From aa_hadec.c */
+void aa_hadec(double, double, double, double *, double *);
+void aa_hadec_n(double, int, double [], double [], double [], double []);
 void hadec_aa(double, double, double, double *, double *);
+void hadec_aa_n(double, int, double [], double [], double [], double []);
 
 /* From altj.c */
 void altj_labels();
 #ifdef _CIRCUM_H
 void altj_display(int, Now *);
+void jm_events_setup(Now *);
 #endif
+void jupmoons(double [], int, int, double [], double [], double []);
 
 /* From altmenus.c */
 void altmenu_init();
@@ -65,6 +70,9 @@ void constellation_msg(int, Now *);
 /* From eq_ecl.c */
 void eq_ecl(double, double, double, double *, double *);
 void ecl_eq(double, double, double, double *, double *);
+void eq_ecl_n(double, int, double [], double [], double [], double []);
+void ecl_eq_n(double, int, double [], double [], double [], double []);
+void eq_ecl_matrix(double, double[3][3]);
 
 /* From flog.c */
 int flog_add(int);
@@ -102,7 +110,11 @@ void byetty();
 void c_pos(int, int);
 void c_erase();
 void c_eol();
+void c_putc(int);
+void c_puts(char *);
+void c_offscreen(char *);
 int chk_char();
+int wait_char(double);
 char read_char();
 int read_line(char *, int);
 
@@ -111,11 +123,15 @@ void listing_setup();
 void listing();
 void listing_prstate(int);
 int listing_ison();
+void listing_close();
+int listing_text(char *, char *);
 
 /* From main.c */
 void print_updating();
 void redraw_screen(int);
 void slp_sync();
+int chk_event();
+void chk_winch();
 
 /* From mainmenu.c */
 void mm_borders();
@@ -128,9 +144,13 @@ void mm_newcir(int);
 
 /* From moon.c */
 void moon(double, double *, double *, double *);
+void moon_n(double [], int, double [], double [], double []);
 
 /* From moonnf.c */
 void moonnf(double, double *, double *);
+double mph_time(long);
+long mph_seed(double, double *);
+int mph_list(double, double, double [], int [], int);
 
 /* From nutation.c */
 void nutation(double, double *, double *);
@@ -153,6 +173,7 @@ void ta_par(double, double, double, double, double, double *, double *);
 
 /* From pelement.c */
 void pelement(double, double[8][9]);
+void pelement1(double, int, double[9]);
 
 /* From plans.c */
 void plans(double, int, double *, double *, double *, double *, double *,
@@ -163,12 +184,39 @@ void plot_setup();
 void plot();
 void plot_prstate(int);
 int plot_ison();
+void plot_close();
 
 /* From popup.c */
 int popup(char **, int, int);
 
 /* From precess.c */
 void precess(double, double, double *, double *);
+void precess_n(double, double, int, double [], double []);
+void precess_matrix(double, double, double[3][3]);
+
+/* From prof.c */
+#ifdef PROFILE
+#define	PF_BODYCIR	0	/* slots for PROF_IN() and PROF_OUT() */
+#define	PF_PLANS	1
+#define	PF_MOON		2
+#define	PF_RISET	3
+#define	PF_EXPR		4
+#define	PF_FLOG		5
+#define	PF_SCREEN	6	/* f_* writes to the screen */
+#define	PF_TTY		7	/* flushing them to the terminal */
+#define	PF_FILE		8	/* plot and listing records */
+#define	PF_N		9
+void prof_init(void);
+void prof_in(int);
+void prof_out(int);
+void prof_poll(void);
+void prof_unwind(void);
+#define	PROF_IN(k)	prof_in(k)
+#define	PROF_OUT(k)	prof_out(k)
+#else
+#define	PROF_IN(k)
+#define	PROF_OUT(k)
+#endif
 
 /* From reduce.c */
 void reduce_elements(double, double, double, double, double, double *,
@@ -186,6 +234,7 @@ void riset(double, double, double, double, double *, double *, double *,
 #ifdef _CIRCUM_H
 int riset_cir(int, Now *, int, int, double *, double *, double *, double *,
               double *, double *, int *);
+void twilight_table(Now *, int, Twilight []);
 #endif
 
 /* From sel_fld.c */
@@ -202,8 +251,17 @@ int srch_ison();
 int srch_eval(double, double *);
 void srch_prstate(int);
 
+/* From stars.c */
+void stars_setfilename(char *);
+void stars_setmag(double);
+int stars_load(char []);
+#ifdef _CIRCUM_H
+void stars_sky(Now *, void (*)(double, double, double));
+#endif
+
 /* From sun.c */
 void sunpos(double, double *, double *);
+void sunpos_counts(long *, long *);
 
 /* From time.c */
 #ifdef _CIRCUM_H
@@ -211,6 +269,8 @@ void set_t0(Now *);
 void time_fromsys(Now *);
 void inc_mjd(Now *, double);
 #endif
+double time_mono();
+double time_real();
 
 /* From utc_gst.c */
 void gst_utc(double, double, double *);
@@ -231,6 +291,17 @@ void credits();
 #ifdef _CIRCUM_H
 void watch_menu(Now *, double, int);
 int watch_function( int, Now *, double, int );
+int watch_frames(int, Now *, double, int, int, char *, char *);
+#endif
+
+/* From yearcal.c */
+#ifdef _CIRCUM_H
+void yearcal_setup(Now *);
+#endif
+
+#ifdef GLOBE_PHOON
+/* From phoon.c */
+void putmoon_forget(void);
 #endif
 
 #endif
@@ -6,8 +6,12 @@
 #define	EQtoECL	1
 #define	ECLtoEQ	(-1)
 
-static
-void ecleq_aux(int sw, double mjd, double x, double y, double *p, double *q);
+static void ecleq_aux (int sw, double mjd, int n, double x[], double y[],
+                       double p[], double q[]);
+static void ecleq_eps (double mjd);
+
+static double lastmjd = -10000;	/* last mjd calculated */
+static double seps, ceps;	/* sin and cos of obliquity for lastmjd */
 
 /* given the modified Julian date, mjd, and an equitorial ra and dec, each in
  * radians, find the corresponding geocentric ecliptic latitude, *lat, and
@@ -19,7 +23,19 @@ void eq_ecl (mjd, ra, dec, lat, lng)
 double mjd, ra, dec;
 double *lat, *lng;
 {
-    ecleq_aux (EQtoECL, mjd, ra, dec, lng, lat);
+    ecleq_aux (EQtoECL, mjd, 1, &ra, &dec, lng, lat);
+}
+
+/* eq_ecl() for each of the n positions ra[] and dec[], into lat[] and lng[],
+ * all for the same mjd so the obliquity is found just once.
+ */
+void eq_ecl_n (mjd, n, ra, dec, lat, lng)
+double mjd;
+int n;
+double ra[], dec[];
+double lat[], lng[];
+{
+    ecleq_aux (EQtoECL, mjd, n, ra, dec, lng, lat);
 }
 
 /* given the modified Julian date, mjd, and a geocentric ecliptic latitude,
@@ -32,19 +48,48 @@ void ecl_eq (mjd, lat, lng, ra, dec)
 double mjd, lat, lng;
 double *ra, *dec;
 {
-    ecleq_aux (ECLtoEQ, mjd, lng, lat, ra, dec);
+    ecleq_aux (ECLtoEQ, mjd, 1, &lng, &lat, ra, dec);
 }
 
-static
-void ecleq_aux (sw, mjd, x, y, p, q)
-int sw;			/* +1 for eq to ecliptic, -1 for vv. */
-double mjd, x, y;	/* sw==1: x==ra, y==dec.  sw==-1: x==lng, y==lat. */
-double *p, *q;		/* sw==1: p==lng, q==lat. sw==-1: p==ra, q==dec. */
+/* ecl_eq() for each of the n positions lat[] and lng[], into ra[] and dec[],
+ * all for the same mjd so the obliquity is found just once.
+ */
+void ecl_eq_n (mjd, n, lat, lng, ra, dec)
+double mjd;
+int n;
+double lat[], lng[];
+double ra[], dec[];
 {
-    static double lastmjd = -10000;	/* last mjd calculated */
-    static double seps, ceps;	/* sin and cos of mean obliquity */
-    double sx, cx, sy, cy, ty;
+    ecleq_aux (ECLtoEQ, mjd, n, lng, lat, ra, dec);
+}
 
+/* given the modified Julian date, mjd, find the matrix, m, that takes an
+ * equatorial unit vector, (cos(dec)cos(ra), cos(dec)sin(ra), sin(dec)), to
+ * the ecliptic one for the same date, (cos(lat)cos(lng), cos(lat)sin(lng),
+ * sin(lat)). its transpose goes the other way.
+ * the obliquity includes nutation, just as for eq_ecl().
+ */
+void eq_ecl_matrix (mjd, m)
+double mjd;
+double m[3][3];
+{
+    ecleq_eps (mjd);
+    m[0][0] = 1.0;
+    m[0][1] = 0.0;
+    m[0][2] = 0.0;
+    m[1][0] = 0.0;
+    m[1][1] = ceps;
+    m[1][2] = seps;
+    m[2][0] = 0.0;
+    m[2][1] = -seps;
+    m[2][2] = ceps;
+}
+
+/* set seps and ceps for mjd unless they already are */
+static void
+ecleq_eps (mjd)
+double mjd;
+{
     if (mjd != lastmjd)
     {
         double eps;
@@ -56,15 +101,38 @@ double *p, *q;		/* sw==1: p==lng, q==lat. sw==-1: p==ra, q==dec. */
         ceps = cos(eps);
         lastmjd = mjd;
     }
+}
+
+/* the one formula for both ways, over n positions.
+ * the loop is kept free of branches and calls other than to the math library
+ * so a compiler may vectorize it; the results are the same as one at a time.
+ */
+static void
+ecleq_aux (sw, mjd, n, x, y, p, q)
+int sw;			/* +1 for eq to ecliptic, -1 for vv. */
+double mjd;
+int n;
+double x[], y[];	/* sw==1: x==ra, y==dec.  sw==-1: x==lng, y==lat. */
+double p[], q[];	/* sw==1: p==lng, q==lat. sw==-1: p==ra, q==dec. */
+{
+    double sseps;	/* seps*sw, exactly */
+    int i;
 
-    sy = sin(y);
-    cy = cos(y);				/* always non-negative */
-    if (fabs(cy)<1e-20) cy = 1e-20;		/* insure > 0 */
-    ty = sy/cy;
-    cx = cos(x);
-    sx = sin(x);
-    *q = asin((sy*ceps)-(cy*seps*sx*sw));
-    *p = atan(((sx*ceps)+(ty*seps*sw))/cx);
-    if (cx<0) *p += PI;		/* account for atan quad ambiguity */
-    range (p, 2*PI);
+    ecleq_eps (mjd);
+    sseps = seps*sw;
+    for (i = 0; i < n; i++)
+    {
+        double sx, cx, sy, cy, ty, pv;
+
+        sy = sin(y[i]);
+        cy = cos(y[i]);				/* always non-negative */
+        cy = fabs(cy)<1e-20 ? 1e-20 : cy;	/* insure > 0 */
+        ty = sy/cy;
+        cx = cos(x[i]);
+        sx = sin(x[i]);
+        q[i] = asin((sy*ceps)-(cy*sseps*sx));
+        pv = atan(((sx*ceps)+(ty*sseps))/cx);
+        pv += cx<0 ? PI : 0.0;		/* account for atan quad ambiguity */
+        p[i] = pv - 2*PI*floor(pv/(2*PI));	/* as range (p, 2*PI) */
+    }
 }
@@ -13,14 +13,23 @@
  * thing at a time (eg, all the X plot values may the same time field, or
  * searching and plotting might be on at one time using the same field) so
  * we consider the field to be in use as long a usage count is > 0.
+ *
+ * the flogs are kept in one array that grows as needed, so there is no
+ * limit to how many may be logged at once, and a table indexed directly by
+ * field finds them (or finds they are not logged) without a search. since
+ * flog_log() is called for every field drawn, this keeps screen updates
+ * quick however many fields are being logged.
  */
 
-#include "string.h"
+#include <stdlib.h>
+#include <string.h>
 #include "screen.h"
 #include "ephem.h"
 
-#define	NFLOGS	132		/* max number of distinct simultaneous logged
-				 * fields
+#define	FLOG_CHUNK	64	/* grow the flog array by at least this many */
+#define	FLOG_NX		0x800	/* size of the field index; 0x7ff is the
+				 * location part of an rcfpack(). any field
+				 * beyond this is found by searching.
 				 */
 
 typedef struct
@@ -33,7 +42,12 @@ typedef struct
 				 */
 } FLog;
 
-static FLog flog[NFLOGS];
+static FLog *flog;		/* malloced array of nflog flogs */
+static int nflog;		/* entries of flog[] in use or once used */
+static int mflog;		/* entries of flog[] allocated */
+static short flogx[FLOG_NX];	/* 1 + index into flog[] of field, or 0 */
+
+static FLog *flog_find (int fld);
 
 /* add fld to the list. if already there, just increment usage count.
  * return 0 if ok, else -1 if no more room.
@@ -44,7 +58,7 @@ int fld;
     FLog *flp, *unusedflp = 0;
 
     /* scan for fld already in list, or find an unused one along the way */
-    for (flp = &flog[NFLOGS]; --flp >= flog; )
+    for (flp = &flog[nflog]; --flp >= flog; )
     {
         if (flp->fl_usagecnt > 0)
         {
@@ -57,13 +71,29 @@ int fld;
         else
             unusedflp = flp;
     }
-    if (unusedflp)
+    if (!unusedflp)
     {
-        unusedflp->fl_fld = fld;
-        unusedflp->fl_usagecnt = 1;
-        return (0);
+        /* no free entry so make the array longer */
+        if (nflog == mflog)
+        {
+            int newm = mflog + (mflog > FLOG_CHUNK ? mflog : FLOG_CHUNK);
+            FLog *newflog;
+            if (newm > 32767)	/* largest flogx[] can index */
+                return (-1);
+            newflog = (FLog *) realloc ((char *)flog, newm*sizeof(FLog));
+            if (!newflog)
+                return (-1);
+            flog = newflog;
+            mflog = newm;
+        }
+        unusedflp = &flog[nflog++];
+        (void) memset ((char *)unusedflp, 0, sizeof(FLog));
     }
-    return (-1);
+    unusedflp->fl_fld = fld;
+    unusedflp->fl_usagecnt = 1;
+    if (fld >= 0 && fld < FLOG_NX)
+        flogx[fld] = unusedflp - flog + 1;
+    return (0);
 }
 
 /* decrement usage count for flog for fld. if goes to 0 take it out of list.
@@ -72,17 +102,14 @@ int fld;
 void flog_delete (fld)
 int fld;
 {
-    FLog *flp;
+    FLog *flp = flog_find (fld);
 
-    for (flp = &flog[NFLOGS]; --flp >= flog; )
-        if (flp->fl_fld == fld && flp->fl_usagecnt > 0)
-        {
-            if (--flp->fl_usagecnt <= 0)
-            {
-                flp->fl_usagecnt = 0;
-            }
-            break;
-        }
+    if (flp && --flp->fl_usagecnt <= 0)
+    {
+        flp->fl_usagecnt = 0;
+        if (fld >= 0 && fld < FLOG_NX)
+            flogx[fld] = 0;
+    }
 }
 
 /* if plotting, listing or searching is active then
@@ -94,21 +121,22 @@ int r, c;
 double val;
 char *str;
 {
+    int s = 0;
+
+    PROF_IN(PF_FLOG);
     if (plot_ison() || listing_ison() || srch_ison())
     {
-        FLog *flp;
-        int fld = rcfpack (r, c, 0);
-        for (flp = &flog[NFLOGS]; --flp >= flog; )
-            if (flp->fl_fld == fld && flp->fl_usagecnt > 0)
-            {
-                flp->fl_val = val;
-                (void) strncpy (flp->fl_str, str, sizeof(flp->fl_str)-1);
-                return(0);
-            }
-        return (-1);
+        FLog *flp = flog_find (rcfpack (r, c, 0));
+        if (flp)
+        {
+            flp->fl_val = val;
+            (void) strncpy (flp->fl_str, str, sizeof(flp->fl_str)-1);
+        }
+        else
+            s = -1;
     }
-    else
-        return (0);
+    PROF_OUT(PF_FLOG);
+    return (s);
 }
 
 /* search for fld in list. if find it, return its value and str, if str.
@@ -118,16 +146,30 @@ int flog_get (fld, vp, str)
 int fld;
 double *vp;
 char *str;
+{
+    FLog *flp = flog_find (fld);
+
+    if (flp)
+    {
+        *vp = flp->fl_val;
+        if (str)
+            (void) strcpy (str, flp->fl_str);
+        return (0);
+    }
+    return (-1);
+}
+
+/* return the flog in use for fld, or 0 if none. */
+static FLog *
+flog_find (fld)
+int fld;
 {
     FLog *flp;
 
-    for (flp = &flog[NFLOGS]; --flp >= flog; )
+    if (fld >= 0 && fld < FLOG_NX)
+        return (flogx[fld] ? &flog[flogx[fld]-1] : (FLog *)0);
+    for (flp = &flog[nflog]; --flp >= flog; )
         if (flp->fl_fld == fld && flp->fl_usagecnt > 0)
-        {
-            *vp = flp->fl_val;
-            if (str)
-                (void) strcpy (str, flp->fl_str);
-            return (0);
-        }
-    return (-1);
+            return (flp);
+    return ((FLog *)0);
 }
@@ -29,9 +29,11 @@ int r, c, n;
 {
     if (f_scrnoff)
         return;
+    PROF_IN(PF_SCREEN);
     c_pos (r, c);
     while (--n >= 0)
-        putchar (' ');
+        c_putc (' ');
+    PROF_OUT(PF_SCREEN);
 }
 
 /* print the given value, v, in "sexadecimal" format at [r,c]
@@ -211,8 +213,10 @@ int row, col, c;
 {
     if (f_scrnoff)
         return;
+    PROF_IN(PF_SCREEN);
     c_pos (row, col);
-    putchar (c);
+    c_putc (c);
+    PROF_OUT(PF_SCREEN);
 }
 
 void f_string (r, c, s)
@@ -221,8 +225,10 @@ char *s;
 {
     if (f_scrnoff)
         return;
+    PROF_IN(PF_SCREEN);
     c_pos (r, c);
-    (void) fputs (s, stdout);
+    c_puts (s);
+    PROF_OUT(PF_SCREEN);
 }
 
 void f_double (r, c, fmt, f)
@@ -240,10 +246,12 @@ double f;
 void f_prompt (p)
 char *p;
 {
+    PROF_IN(PF_SCREEN);
     c_pos (R_PROMPT, C_PROMPT);
     c_eol ();
     c_pos (R_PROMPT, C_PROMPT);
-    (void) fputs (p, stdout);
+    c_puts (p);
+    PROF_OUT(PF_SCREEN);
 }
 
 /* clear from [r,c] to end of line, if we are drawing now. */
@@ -252,8 +260,10 @@ int r, c;
 {
     if (!f_scrnoff)
     {
+        PROF_IN(PF_SCREEN);
         c_pos (r, c);
         c_eol();
+        PROF_OUT(PF_SCREEN);
     }
 }
 
@@ -1,17 +1,21 @@
 /* this file (in principle) contains all the device-dependent code for
  * handling screen movement and reading the keyboard. public routines are:
- *   c_pos(r,c), c_erase(), c_eol();
+ *   c_pos(r,c), c_erase(), c_eol(), c_putc(c), c_puts(s);
+ *   c_offscreen(buf);
  *   chk_char(), read_char(), read_line (buf, max); and
  *   byetty().
  * N.B. we assume output may be performed by printf(), putchar() and
  *   fputs(stdout). since these are buffered we flush first in read_char().
+ *   only what goes through c_putc() and c_puts() can be drawn offscreen.
  */
 
 /* explanation of various conditional #define options:
  * UNIX: uses termcap for screen management.
  *   USE_TERMIO: use termio.h to control tty modes.
  *   USE_SGTTY: use sgtty.h to control tty modes.
- *   USE_NDELAY: do non-blocking tty reads with fcntl(O_NDELAY).
+ *   USE_NDELAY: do non-blocking tty reads with fcntl(O_NDELAY). where the
+ *     system has O_ASYNC, SIGIO tells us when there may be input so most
+ *     calls to chk_char() need no system calls at all.
  *   USE_FIONREAD: do non-blocking tty reads with ioctl(FIONREAD).
  *   USE_ATTSELECT: do non-blocking reads with att's select(2) (4 args).
  *   USE_BSDSELECT: do non-blocking reads with bsd's select(2) (5 args).
@@ -54,6 +58,87 @@
 #include <string.h>
 
 #include "screen.h"
+#include "ephem.h"
+
+/* offscreen drawing.
+ * while c_offscreen() has been given a buffer of NR*NC chars, row by row,
+ * c_pos(), c_erase() and c_eol() and the output of c_putc() and c_puts()
+ * work on it rather than on the terminal, so whole screens may be drawn
+ * with no tty at all. anything that would fall off the buffer is dropped.
+ */
+static char *vs_buf;	/* NR*NC chars, or 0 when drawing on the terminal */
+static int vs_r, vs_c;	/* cursor in vs_buf, 0 based */
+
+void c_offscreen (buf)
+char *buf;
+{
+    vs_buf = buf;
+    vs_r = vs_c = 0;
+}
+
+/* move the offscreen cursor; return 1 if we are offscreen, else 0 */
+static int
+vs_pos (r, c)
+int r, c;
+{
+    if (!vs_buf)
+        return (0);
+    vs_r = r-1;
+    vs_c = c-1;
+    return (1);
+}
+
+/* blank the offscreen buffer; return 1 if we are offscreen, else 0 */
+static int
+vs_erase()
+{
+    if (!vs_buf)
+        return (0);
+    (void) memset (vs_buf, ' ', NR*NC);
+    vs_r = vs_c = 0;
+    return (1);
+}
+
+/* blank the rest of the offscreen row; return 1 if we are offscreen, else 0 */
+static int
+vs_eol()
+{
+    if (!vs_buf)
+        return (0);
+    if (vs_r >= 0 && vs_r < NR && vs_c < NC)
+    {
+        int c = vs_c < 0 ? 0 : vs_c;
+        (void) memset (vs_buf + vs_r*NC + c, ' ', NC - c);
+    }
+    return (1);
+}
+
+/* put one char at the cursor and move it right */
+void c_putc (c)
+int c;
+{
+    if (!vs_buf)
+    {
+        putchar (c);
+        return;
+    }
+    if (vs_r >= 0 && vs_r < NR && vs_c >= 0 && vs_c < NC)
+        vs_buf[vs_r*NC + vs_c] = c;
+    vs_c++;
+}
+
+/* put a string at the cursor and move it right */
+void c_puts (s)
+char *s;
+{
+    if (!vs_buf)
+    {
+        (void) fputs (s, stdout);
+        return;
+    }
+    while (*s)
+        c_putc (*s++);
+}
 
 #ifdef UNIX
 #include <signal.h>
@@ -76,6 +161,9 @@
 #ifdef USE_NDELAY
 #include <fcntl.h>
 #endif
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
 
 extern char *tgoto();
 static char *cm, *ce, *cl, *ks, *ke, *kl, *kr, *ku, *kd; /* termcap sequences */
@@ -97,6 +185,8 @@ static void setuptty();
 void c_pos (r, c)
 int r, c;
 {
+    if (vs_pos (r, c))
+        return;
     if (!tloaded) tload();
     fputs (tgoto (cm, c-1, r-1), stdout);
 }
@@ -104,6 +194,8 @@ int r, c;
 /* erase entire screen. */
 void c_erase()
 {
+    if (vs_erase())
+        return;
     if (!tloaded) tload();
     fputs (cl, stdout);
 }
@@ -111,12 +203,58 @@ void c_erase()
 /* erase to end of line */
 void c_eol()
 {
+    if (vs_eol())
+        return;
     if (!tloaded) tload();
     fputs (ce, stdout);
 }
 
 #ifdef USE_NDELAY
 static char sav_char;	/* one character read-ahead for chk_char() */
+static int ndelay_on;	/* set while fd 0 is in O_NDELAY mode */
+static int async_fl;	/* O_ASYNC if SIGIO is working for us, else 0 */
+#ifdef O_ASYNC
+#define	KBD_STALE	0.25	/* check fd 0 anyway after this many secs */
+static volatile sig_atomic_t kbd_ready = 1; /* set when input may be waiting */
+static double kbd_last;	/* when we last checked fd 0 */
+
+/* SIGIO handler: fd 0 has input */
+static void
+on_io()
+{
+    kbd_ready = 1;
+}
+
+/* return 1 if it has been a while since we last checked fd 0 for input,
+ * just in case a SIGIO went astray, else 0.
+ */
+static int
+kbd_stale()
+{
+    struct timespec ts;
+    double t;
+
+    (void) clock_gettime (CLOCK_MONOTONIC, &ts);
+    t = ts.tv_sec + ts.tv_nsec*1e-9;
+    if (t - kbd_last < KBD_STALE)
+        return (0);
+    kbd_last = t;
+    return (1);
+}
+#endif
+
+/* put fd 0 into non-blocking mode if on, else blocking, if not already. */
+static void
+set_ndelay (on)
+int on;
+{
+    if (on != ndelay_on)
+    {
+        /* non-blocking read. FNDELAY on BSD */
+        fcntl (0, F_SETFL, (on ? O_NDELAY : 0) | async_fl);
+        ndelay_on = on;
+    }
+}
 #endif
 
 /* return 0 if there is a char that may be read without blocking, else -1 */
@@ -124,18 +262,31 @@ int chk_char()
 {
 #ifdef USE_NDELAY
     if (!ttysetup) setuptty();
+    PROF_IN(PF_TTY);
     fflush (stdout);
+    PROF_OUT(PF_TTY);
     if (sav_char)
         return (0);
-    fcntl (0, F_SETFL, O_NDELAY);	/* non-blocking read. FNDELAY on BSD */
+#ifdef O_ASYNC
+    if (async_fl && !kbd_ready && !kbd_stale())
+        return (-1);
+    kbd_ready = 0;	/* clear before read so no SIGIO is lost */
+#endif
+    set_ndelay (1);
     if (read (0, &sav_char, 1) != 1)
         sav_char = 0;
+#ifdef O_ASYNC
+    else
+        kbd_ready = 1;	/* there may be more */
+#endif
     return (sav_char ? 0 : -1);
 #endif
 #ifdef USE_ATTSELECT
     int nfds, rfds, wfds, to;
     if (!ttysetup) setuptty();
+    PROF_IN(PF_TTY);
     fflush (stdout);
+    PROF_OUT(PF_TTY);
     rfds = 1 << 0;	/* reads are on fd 0 */
     wfds = 0;	/* not interested in any write fds */
     nfds = 1;	/* check only fd 0 */
@@ -146,7 +297,9 @@ int chk_char()
     int nfds, rfds, wfds, xfds;
     struct timeval to;
     if (!ttysetup) setuptty();
+    PROF_IN(PF_TTY);
     fflush (stdout);
+    PROF_OUT(PF_TTY);
     rfds = 1 << 0;	/* reads are on fd 0 */
     wfds = 0;	/* not interested in any write fds */
     xfds = 0;	/* not interested in any exception fds */
@@ -158,12 +311,62 @@ int chk_char()
 #ifdef USE_FIONREAD
     long n;
     if (!ttysetup) setuptty();
+    PROF_IN(PF_TTY);
     fflush (stdout);
+    PROF_OUT(PF_TTY);
     ioctl (0, FIONREAD, &n);
     return (n > 0 ? 0 : -1);
 #endif
 }
 
+/* wait until there is a char that may be read without blocking, or until
+ * secs seconds have passed, whichever is first, without using the cpu.
+ * return 0 if there is a char, else -1.
+ */
+int wait_char (secs)
+double secs;
+{
+    struct timespec ts;
+    double deadline;
+
+    if (chk_char() == 0)
+        return (0);
+
+    /* work to a fixed deadline so being interrupted, such as by SIGWINCH,
+     * does not stretch the wait.
+     */
+    (void) clock_gettime (CLOCK_MONOTONIC, &ts);
+    deadline = ts.tv_sec + ts.tv_nsec*1e-9 + secs;
+    while (1)
+    {
+        struct pollfd pfd;
+        double rem;
+
+        (void) clock_gettime (CLOCK_MONOTONIC, &ts);
+        rem = deadline - (ts.tv_sec + ts.tv_nsec*1e-9);
+        if (rem <= 0)
+            return (-1);
+        pfd.fd = 0;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        switch (poll (&pfd, 1, (int)(rem*1000.0) + 1))
+        {
+        case 0:
+            break;	/* timed out, but check rem again to be sure */
+        case -1:
+            if (errno != EINTR)
+                return (-1);
+            chk_winch();	/* such as for a new screen size */
+            break;
+        default:
+#if defined(USE_NDELAY) && defined(O_ASYNC)
+            kbd_ready = 1;	/* in case SIGIO is not here yet */
+#endif
+            return (chk_char());
+        }
+    }
+}
+
 /* used to time out of a read */
 static int got_alrm;
 static void
@@ -222,9 +425,14 @@ char read_char()
 {
     char c;
     if (!ttysetup) setuptty();
+    PROF_IN(PF_TTY);
     fflush (stdout);
+    PROF_OUT(PF_TTY);
 #ifdef USE_NDELAY
-    fcntl (0, F_SETFL, 0);	/* blocking read */
+    set_ndelay (0);	/* blocking read */
+#ifdef O_ASYNC
+    kbd_ready = 1;	/* there may be more after this one */
+#endif
     if (sav_char)
     {
         c = sav_char;
@@ -232,7 +440,8 @@ char read_char()
     }
     else
 #endif
-        read (0, &c, 1);
+        while (read (0, &c, 1) < 0 && errno == EINTR)
+            chk_winch();	/* such as for a new screen size, then read on */
     c = chk_arrow (c & 0177); /* just ASCII, please */
     return (c);
 }
@@ -256,6 +465,8 @@ void byetty()
 #endif
 #ifdef USE_NDELAY
     fcntl (0, F_SETFL, 0);	/* be sure to go back to blocking read */
+    ndelay_on = 0;
+    async_fl = 0;
 #endif
     ttysetup = 0;
 }
@@ -365,6 +576,16 @@ static void setuptty()
     sg.sg_flags |= XTABS;	/* no tabs with termcap */
     sg.sg_flags |= CBREAK;	/* wake up on each char but can still kill */
     ioctl (0, TIOCSETP, &sg);
+#endif
+#if defined(USE_NDELAY) && defined(O_ASYNC)
+    /* ask for SIGIO when there is input */
+    (void) signal (SIGIO, on_io);
+    kbd_ready = 1;
+    if (fcntl (0, F_SETOWN, getpid()) == 0 && fcntl (0, F_SETFL, O_ASYNC) == 0)
+        async_fl = O_ASYNC;
+    else
+        async_fl = 0;
+    ndelay_on = 0;
 #endif
     ttysetup = 1;
 }
@@ -380,18 +601,24 @@ static void setuptty()
 c_pos (r, c)
 int r, c;
 {
+    if (vs_pos (r, c))
+        return;
     printf ("%c[%d;%df", ESC, r, c);
 }
 
 /* erase entire screen. (ANSI: ESC [ 2 J) */
 c_erase()
 {
+    if (vs_erase())
+        return;
     printf ("%c[2J", ESC);
 }
 
 /* erase to end of line. (ANSI: ESC [ K) */
 c_eol()
 {
+    if (vs_eol())
+        return;
     printf ("%c[K", ESC);
 }
 #else
@@ -403,6 +630,8 @@ union REGS rg;
 c_pos (r, c)
 int r, c;
 {
+    if (vs_pos (r, c))
+        return;
     rg.h.ah = 2;
     rg.h.bh = 0;
     rg.h.dh = r-1;
@@ -414,6 +643,9 @@ int r, c;
 c_erase()
 {
     int cur_cursor, i;
+
+    if (vs_erase())
+        return;
     rg.h.ah = 3;
     rg.h.bh = 0;
     int86(16,&rg,&rg);
@@ -438,6 +670,9 @@ c_erase()
 c_eol()
 {
     int cur_cursor, i;
+
+    if (vs_eol())
+        return;
     rg.h.ah = 3;
     rg.h.bh = 0;
     int86(16,&rg,&rg);
@@ -776,6 +1011,8 @@ int r, c;
     unsigned long capcode;   /* capability code              */
     char seq[2*MAXCAP];      /* returned string              */
 
+    if (vs_pos (r, c))
+        return;
     if (!ttchan) inittt();
 
     /* Set cursor depends on the position, therefore we have to call
@@ -796,6 +1033,8 @@ int r, c;
 /* erase entire screen. */
 c_erase()
 {
+    if (vs_erase())
+        return;
     if (!ttchan) inittt();
 
     fputs(cl,stdout);
@@ -804,6 +1043,8 @@ c_erase()
 /* erase to end of line. */
 c_eol()
 {
+    if (vs_eol())
+        return;
     if (!ttchan) inittt();
 
     fputs(ce,stdout);
@@ -894,18 +1135,24 @@ void gotoxy(int x, int y)
 c_pos (r, c)
 int r, c;
 {
+    if (vs_pos (r, c))
+        return;
     gotoxy(r,c-1);
 }
 
 /* erase entire screen. (ANSI: ESC [ 2 J) */
 c_erase()
 {
+    if (vs_erase())
+        return;
     clear();
 }
 
 /* erase to end of line. (ANSI: ESC [ K) */
 c_eol()
 {
+    if (vs_eol())
+        return;
     clrtoeol();
 }
 
@@ -961,6 +1208,25 @@ sleep(int seconds)
 
 #endif	/* WIN32 */
 
+#ifndef UNIX
+/* wait until there is a char that may be read without blocking, or until
+ * secs seconds have passed, whichever is first.
+ * return 0 if there is a char, else -1.
+ */
+int wait_char (secs)
+double secs;
+{
+    int n;
+
+    for (n = (int)(secs + 0.999); n > 0; n--)
+        if (chk_char() == 0)
+            return (0);
+        else
+            (void) sleep (1);
+    return (chk_char());
+}
+#endif
+
 /* read up to max chars into buf, with cannonization.
  * add trailing '\0' (buf is really max+1 chars long).
  * return count of chars read (not counting '\0').
@@ -4,6 +4,7 @@
  * the listing file in the same manner as they appeared on the screen.
  *
  * format of the listing file is one line per screen update.
+ * or, the file may be written as packed binary records; see binio.h.
  */
 
 #include <stdio.h>
@@ -14,6 +15,7 @@
 
 #include "screen.h"
 #include "ephem.h"
+#include "binio.h"
 
 #ifdef VMS
 #include <perror.h>
@@ -28,26 +30,46 @@
 
 #define	TRACE(x)	{FILE *fp = fopen("trace","a"); fprintf x; fclose(fp);}
 
-#define	MAXLSTFLDS	132	/* max number of fields we can track.
-				 * note we can't store more than NFLOGS fields
-				 * anyway (see flog.c).
-				 */
+#define	LSTCHUNK	32	/* grow lstflds[] by this many at once */
 #define	FNLEN		(14+1)	/* longest filename; plus 1 for \0 */
+#define	LV_NCKP		1024	/* max checkpoints into a viewed listing */
+#define	LV_LINELEN	4096	/* longest listing line shown, chars */
 
 static char lst_filename[FNLEN] = "ephem.lst";	/* default plot file name */
 static FILE *lst_fp;		/* the plot file; == 0 means don't plot */
+static BinFile *lst_bp;		/* or the binary listing file */
+static int lst_format;		/* BIN_TEXT, BIN_PACKED or BIN_GZIP */
 
 /* store rcfpack()s for each field to track, in l-to-r order */
-static int lstflds[MAXLSTFLDS];
+static int *lstflds;		/* malloced array of fields to list */
+static double *lstvals;		/* room for a value of each, for binary */
 static int nlstflds;		/* number of lstflds[] in actual use */
+static int mlstflds;		/* number of lstflds[] and lstvals[] allocated */
 
 static int lstsrchfld;		/* set when the Search field is to be listed */
 
+/* a listing file being viewed, with a sparse index of where every
+ * lv_stride'th line starts so any part of it may be reached quickly.
+ */
+typedef struct
+{
+    FILE *lv_fp;		/* the file */
+    long lv_nlines;		/* total lines in file */
+    long lv_ckp[LV_NCKP];	/* offset of line i*lv_stride */
+    int lv_nckp;		/* entries in lv_ckp[] in use */
+    long lv_stride;		/* lines between lv_ckp[] entries */
+} LstView;
+
 static void lst_select_fields();
 static void lst_turn_off ();
 static void lst_turn_on ();
 static void lst_file ();
+static FILE *bin_listing_text (char *fn);
 static void display_listing_file (FILE *lfp);
+static void lv_index (LstView *lvp);
+static void lv_seek (LstView *lvp, long k);
+static int lv_getline (FILE *fp, char *buf, int n);
+static long lv_find (LstView *lvp, long k0, char *pat);
 
 /* picked the Listing label:
  * if on, just turn it off.
@@ -56,17 +78,19 @@ static void display_listing_file (FILE *lfp);
  */
 void listing_setup()
 {
-    if (lst_fp)
+    if (listing_ison())
         lst_turn_off();
     else
     {
         static char *chcs[] =
         {
-            "Select fields", "Display a listing file", "Begin listing"
+            "Select fields", "Display a listing file", (char *)0,
+            "Begin listing"
         };
         static int fn;	/* start with 0, then remember for next time */
 ask:
-        switch (popup(chcs, fn, nlstflds > 0 ? 3 : 2))
+        chcs[2] = bin_fmtname (lst_format);
+        switch (popup(chcs, fn, nlstflds > 0 ? 4 : 3))
         {
         case 0:
             fn = 0;
@@ -78,6 +102,10 @@ ask:
             goto ask;
         case 2:
             fn = 2;
+            lst_format = bin_nextfmt (lst_format);
+            goto ask;
+        case 3:
+            fn = 3;
             lst_turn_on();
             break;
         default:
@@ -89,7 +117,7 @@ ask:
 /* write the active listing to the current listing file, if one is open. */
 void listing()
 {
-    if (lst_fp)
+    if (listing_ison())
     {
         int n;
         double flx;
@@ -118,18 +146,78 @@ void listing()
         }
 
         /* list in order of original selection */
-        for (n = 0; n < nlstflds; n++)
-            if (flog_get (lstflds[n], &flx, flstr) == 0)
-                (void) fprintf (lst_fp, "%s  ", flstr);
-        (void) fprintf (lst_fp, "\n");
+        PROF_IN(PF_FILE);
+        if (lst_bp)
+        {
+            double *v = lstvals;
+            for (n = 0; n < nlstflds; n++)
+                if (flog_get (lstflds[n], &v[n], (char *)0) < 0)
+                    v[n] = NAN;
+            bin_rec (lst_bp, 'L', nlstflds, v);
+        }
+        else
+        {
+            for (n = 0; n < nlstflds; n++)
+                if (flog_get (lstflds[n], &flx, flstr) == 0)
+                    (void) fprintf (lst_fp, "%s  ", flstr);
+            (void) fprintf (lst_fp, "\n");
+        }
+        PROF_OUT(PF_FILE);
+    }
+}
+
+/* write a block of preformatted text, such as a report of search results,
+ * to the listing file in one go.
+ * if listing is not on, open the listing file just long enough to append it.
+ * return 0 if ok, else -1 with a reason in errbuf.
+ */
+int listing_text (text, errbuf)
+char *text;
+char *errbuf;
+{
+    FILE *fp;
+    int fmt;
+
+    if (lst_bp)
+    {
+        bin_text (lst_bp, text);
+        return (0);
+    }
+    fmt = lst_fp ? BIN_TEXT : bin_format (lst_filename);
+    if (fmt > BIN_TEXT)
+    {
+        BinFile *bp = bin_create (lst_filename, "a", fmt == BIN_GZIP, "list",
+                                  0, (char **)0, errbuf);
+        if (!bp)
+            return (-1);
+        bin_text (bp, text);
+        if (bin_close (bp) < 0)
+        {
+            (void) sprintf (errbuf, "error writing %s", lst_filename);
+            return (-1);
+        }
+        return (0);
+    }
+
+    fp = lst_fp ? lst_fp : fopen (lst_filename, "a");
+    if (!fp)
+    {
+        (void) sprintf (errbuf, "can not open %s: %s", lst_filename, errsys);
+        return (-1);
     }
+    (void) fputs (text, fp);
+    if (fp != lst_fp)
+        (void) fclose (fp);
+    else
+        (void) fflush (fp);
+    return (0);
 }
 
 void listing_prstate (force)
 int force;
 {
     static int last;
-    int this = lst_fp != 0;
+    int this = listing_ison();
 
     if (force || this != last)
     {
@@ -140,7 +228,14 @@ int force;
 
 int listing_ison()
 {
-    return (lst_fp != 0);
+    return (lst_fp != 0 || lst_bp != 0);
+}
+
+/* turn listing off if it is on, so the file is complete, as on exit. */
+void listing_close()
+{
+    if (listing_ison())
+        lst_turn_off();
 }
 
 static
@@ -172,8 +267,25 @@ void lst_select_fields()
     int i;
 
     lst_reset();
-    for (i = 0; i < MAXLSTFLDS; i++)
+    for (i = 0; i < BIN_MAXN; i++)
     {
+        if (i == mlstflds)
+        {
+            int newm = mlstflds + LSTCHUNK;
+            int *newf = (int *) realloc ((char *)lstflds, newm*sizeof(int));
+            double *newv;
+            if (newf)
+                lstflds = newf;
+            newv = (double *) realloc ((char *)lstvals, newm*sizeof(double));
+            if (newv)
+                lstvals = newv;
+            if (!newf || !newv)
+            {
+                f_msg (sry);
+                break;
+            }
+            mlstflds = newm;
+        }
         (void) sprintf(buf,"select field for column %d or q to quit", i+1);
         f = sel_fld (f, alt_menumask()|F_PLT, buf, hlp);
         if (!f)
@@ -187,7 +299,7 @@ void lst_select_fields()
         if (f == sf)
             lstsrchfld = 1;
     }
-    if (i == MAXLSTFLDS)
+    if (i == BIN_MAXN)
         f_msg (sry);
     nlstflds = i;
 }
@@ -195,7 +307,14 @@ void lst_select_fields()
 static
 void lst_turn_off ()
 {
-    (void) fclose (lst_fp);
+    if (lst_bp)
+    {
+        if (bin_close (lst_bp) < 0)
+            f_msg ("Error writing listing file.");
+        lst_bp = 0;
+    }
+    else
+        (void) fclose (lst_fp);
     lst_fp = 0;
     listing_prstate(0);
 }
@@ -252,19 +371,56 @@ void lst_turn_on ()
     }
 
     /* listing is on if file opens ok */
-    lst_fp = fopen (lst_filename, optype);
-    if (!lst_fp)
+    if (lst_format != BIN_TEXT)
     {
-        (void) sprintf (fnq, "can not open %s: %s", lst_filename, errsys);
-        f_msg (fnq);
+        /* name each field by its screen location */
+        char (*names)[16] = (char (*)[16]) malloc (nlstflds*16 + 1);
+        char **np = (char **) malloc (nlstflds*sizeof(char *) + 1);
+
+        if (!names || !np)
+        {
+            f_msg ("Sorry; no memory for field names.");
+            if (names) free ((char *)names);
+            if (np) free ((char *)np);
+            return;
+        }
+        for (n = 0; n < nlstflds; n++)
+        {
+            (void) sprintf (names[n], "%d,%d", unpackr(lstflds[n]),
+                            unpackc(lstflds[n]));
+            np[n] = names[n];
+        }
+        lst_bp = bin_create (lst_filename, optype, lst_format == BIN_GZIP,
+                             "list", nlstflds, np, fnq);
+        free ((char *)names);
+        free ((char *)np);
+        if (!lst_bp)
+            f_msg (fnq);
     }
     else
+    {
+        lst_fp = fopen (lst_filename, optype);
+        if (!lst_fp)
+        {
+            (void) sprintf (fnq, "can not open %s: %s", lst_filename,
+                            errsys);
+            f_msg (fnq);
+        }
+        else
+            (void) setvbuf (lst_fp, (char *)0, _IOFBF, BIN_BUFSZ);
+    }
+    if (listing_ison())
     {
         /* add a title if desired */
         static char tp[] = "Title (q to skip): ";
         f_prompt (tp);
         if (read_line (fnq, PW - sizeof(tp)) > 0)
-            (void) fprintf (lst_fp, "%s\n", fnq);
+        {
+            if (lst_bp)
+                bin_text (lst_bp, fnq);
+            else
+                (void) fprintf (lst_fp, "%s\n", fnq);
+        }
     }
 
     listing_prstate (0);
@@ -292,8 +448,15 @@ void lst_file ()
     if (n > 0)
         (void) strcpy (lst_filename, fn);
 
-    /* show it if file opens ok */
-    lfp = fopen (lst_filename, "r");
+    /* show it if file opens ok; binary files are shown as text */
+    if (bin_format (lst_filename) > BIN_TEXT)
+    {
+        lfp = bin_listing_text (lst_filename);
+        if (!lfp)
+            return;
+    }
+    else
+        lfp = fopen (lst_filename, "r");
     if (lfp)
     {
         display_listing_file (lfp);
@@ -308,57 +471,273 @@ void lst_file ()
     }
 }
 
+/* convert the binary listing file fn to text in a temporary file, in the
+ * manner of a text listing file, and return it rewound ready to read.
+ * if trouble, say why and return 0.
+ */
+static FILE *
+bin_listing_text (fn)
+char *fn;
+{
+    char buf[NC];
+    double *v;
+    BinFile *bp;
+    FILE *tfp;
+    int tag, n, i;
+
+    bp = bin_open (fn, "list", buf);
+    if (!bp)
+    {
+        f_msg (buf);
+        return ((FILE *)0);
+    }
+    v = (double *) malloc (BIN_MAXN*sizeof(double));
+    tfp = v ? tmpfile() : (FILE *)0;
+    if (!tfp)
+    {
+        (void) sprintf (buf, "can not make temp file: %s", errsys);
+        f_msg (buf);
+        (void) bin_close (bp);
+        if (v) free ((char *)v);
+        return ((FILE *)0);
+    }
+
+    while ((n = bin_next (bp, &tag, v, BIN_MAXN, buf, sizeof(buf))) >= 0)
+    {
+        if (tag == '*')
+        {
+            (void) fputs (buf, tfp);
+            if (n == 0 || buf[n-1] != '\n')
+                (void) putc ('\n', tfp);
+            continue;
+        }
+        for (i = 0; i < n; i++)
+            if (!isnan (v[i]))
+                (void) fprintf (tfp, "%g  ", v[i]);
+        (void) putc ('\n', tfp);
+    }
+
+    (void) bin_close (bp);
+    free ((char *)v);
+    rewind (tfp);
+    return (tfp);
+}
+
 /* display the given listing file on the screen.
- * allow for files longer than the screen.
+ * allow for files longer and wider than the screen: a sparse index of line
+ * offsets, of fixed size however long the file, lets the operator page
+ * either way, jump to any row and search for any text.
  * N.B. do whatever you like but redraw the screen when done.
  */
-static
-void display_listing_file (lfp)
+static void
+display_listing_file (lfp)
 FILE *lfp;
 {
-    static const char eofp[] = "[End-of-file. Hit any key to resume...] ";
-    static const char p[] =    "[Hit any key to continue or q to quit...] ";
-    char buf[NC+2];	/* screen width plus for '\n' and '\0' */
-    int nc, nl;
+    static char keys[] =
+        "SPACE/b page, t/e end, </> pan, r row, / find, n next, q";
+    static char pat[64];	/* last search string, for n */
+    LstView lv;
+    char buf[LV_LINELEN];
+    long top = 0;		/* index of line at top of screen */
+    int hoff = 0;		/* first column shown */
+    int nrows = NR-1;		/* lines of listing per screen */
+
+    lv.lv_fp = lfp;
+    f_prompt ("Indexing listing file...");
+    lv_index (&lv);
 
-    c_erase();
-    nl = 0;
     while (1)
     {
-        char *rv = fgets (buf, sizeof(buf), lfp);
-        if (rv==NULL || feof(lfp))
-        {
-            printf (eofp);
-            (void) read_char();
-            break;
-        }
-        /* make sure last char is \n, even if it's a long line */
-        nc = strlen (buf);
-        if (nc == NC+1)
+        long row;
+        int r, c;
+
+        /* show one screenful starting with line top */
+        c_erase();
+        lv_seek (&lv, top);
+        for (r = 1; r <= nrows && lv_getline (lfp, buf, sizeof(buf)) >= 0;
+                r++)
         {
-            (void) ungetc (buf[NC], lfp);
-            buf[NC] = '\n';
+            int l = strlen (buf);
+            if (l > hoff)
+            {
+                c_pos (r, 1);
+                (void) fwrite (buf+hoff, 1, l-hoff > NC ? NC : l-hoff, stdout);
+            }
         }
-        printf ("%s\r", buf);
-        if (++nl == NR-1)
+        (void) sprintf (buf, "[%ld-%ld of %ld] %s", top+1,
+                        top+nrows < lv.lv_nlines ? top+nrows : lv.lv_nlines,
+                        lv.lv_nlines, keys);
+        buf[NC-1] = '\0';
+        c_pos (NR, 1);
+        (void) fputs (buf, stdout);
+
+        switch (c = read_char())
         {
-            /* read-ahead one char to check for eof */
-            int rach = getc (lfp);
-            if (feof(lfp))
-            {
-                (void) printf (eofp);
-                (void) read_char();
+        case 'b':
+            top -= nrows;
+            break;
+        case 't':
+            top = 0;
+            break;
+        case 'e':
+            top = lv.lv_nlines - nrows;
+            break;
+        case '<':
+            hoff = hoff > NC/2 ? hoff - NC/2 : 0;
+            break;
+        case '>':
+            if (hoff + NC/2 < LV_LINELEN-1)
+                hoff += NC/2;
+            break;
+        case 'r':
+            f_prompt ("row: ");
+            if (read_line (buf, 10) > 0 && sscanf (buf, "%ld", &row) == 1)
+                top = row - 1;
+            break;
+        case '/':
+            f_prompt ("find: ");
+            if (read_line (buf, sizeof(pat)-1) <= 0)
                 break;
+            (void) strcpy (pat, buf);
+            /* fall through */
+        case 'n':
+            if (!pat[0])
+                break;
+            row = lv_find (&lv, top+1, pat);
+            if (row < 0)
+            {
+                (void) sprintf (buf, "\"%s\" not found", pat);
+                f_msg (buf);
             }
             else
-                (void) ungetc (rach, lfp);
-            (void) printf (p);
-            if (read_char() == END)
-                break;
-            c_erase();
-            nl = 0;
+                top = row;
+            break;
+        case END:
+            goto out;
+        default:
+            /* any other key pages forward, or quits from the last page */
+            if (top + nrows >= lv.lv_nlines)
+                goto out;
+            top += nrows;
+            break;
         }
+
+        if (top > lv.lv_nlines - nrows)
+            top = lv.lv_nlines - nrows;
+        if (top < 0)
+            top = 0;
     }
+out:
 
     redraw_screen (2);	/* full redraw */
 }
+
+/* pass once through the listing file counting its lines and filling in
+ * the checkpoints, keeping them to LV_NCKP by doubling the stride as needed.
+ */
+static void
+lv_index (lvp)
+LstView *lvp;
+{
+    FILE *fp = lvp->lv_fp;
+    long off = 0;
+    long k = 0;
+    int c, bol = 1;
+
+    rewind (fp);
+    lvp->lv_stride = 1;
+    lvp->lv_nckp = 0;
+    while ((c = getc (fp)) != EOF)
+    {
+        if (bol)
+        {
+            if (k % lvp->lv_stride == 0)
+            {
+                if (lvp->lv_nckp == LV_NCKP)
+                {
+                    int i;
+                    for (i = 0; i < LV_NCKP/2; i++)
+                        lvp->lv_ckp[i] = lvp->lv_ckp[2*i];
+                    lvp->lv_nckp = LV_NCKP/2;
+                    lvp->lv_stride *= 2;
+                }
+                if (k % lvp->lv_stride == 0)
+                    lvp->lv_ckp[lvp->lv_nckp++] = off;
+            }
+            k++;
+            bol = 0;
+        }
+        if (c == '\n')
+            bol = 1;
+        off++;
+    }
+    lvp->lv_nlines = k;
+    if (lvp->lv_nckp == 0)
+        lvp->lv_ckp[lvp->lv_nckp++] = 0;
+}
+
+/* position the listing file so the next line read is line k, from the
+ * nearest checkpoint before it.
+ */
+static void
+lv_seek (lvp, k)
+LstView *lvp;
+long k;
+{
+    long j = k / lvp->lv_stride;
+    int c;
+
+    if (j >= lvp->lv_nckp)
+        j = lvp->lv_nckp - 1;
+    (void) fseek (lvp->lv_fp, lvp->lv_ckp[j], 0);
+    for (j *= lvp->lv_stride; j < k; j++)
+        while ((c = getc (lvp->lv_fp)) != '\n')
+            if (c == EOF)
+                return;
+}
+
+/* read the next line from fp into buf, without its '\n', dropping whatever
+ * does not fit in n-1 chars.
+ * return its length, or -1 at eof.
+ */
+static int
+lv_getline (fp, buf, n)
+FILE *fp;
+char *buf;
+int n;
+{
+    int l = 0;
+    int c;
+
+    while ((c = getc (fp)) != EOF && c != '\n')
+        if (l < n-1)
+            buf[l++] = c;
+    buf[l] = '\0';
+    return (c == EOF && l == 0 ? -1 : l);
+}
+
+/* find the first line containing pat, starting at line k0 and wrapping
+ * around the end of the file.
+ * return its index, or -1 if none.
+ */
+static long
+lv_find (lvp, k0, pat)
+LstView *lvp;
+long k0;
+char *pat;
+{
+    char buf[LV_LINELEN];
+    long k;
+
+    if (k0 >= lvp->lv_nlines)
+        k0 = 0;
+    lv_seek (lvp, k0);
+    for (k = k0; lv_getline (lvp->lv_fp, buf, sizeof(buf)) >= 0; k++)
+        if (strstr (buf, pat))
+            return (k);
+    lv_seek (lvp, 0L);
+    for (k = 0; k < k0 && lv_getline (lvp->lv_fp, buf, sizeof(buf)) >= 0; k++)
+        if (strstr (buf, pat))
+            return (k);
+    return (-1);
+}
@@ -53,6 +53,8 @@ extern char *getenv();
 static jmp_buf fpe_err_jmp;	/* used to recover from SIGFPE */
 static char *cfgfile;		/* !0 if -c used */
 static char *watchmode;	/* !0 if -W used */
+static int nframes;	/* !0 if -F used: save this many -W frames */
+static char *framefile;	/* !0 if -o used: file for the -F frames */
 static char cfgdef[] = "ephem.cfg"; /* default configuration file name */
 static Now now;		/* where when and how, right now */
 static double tminc;	/* hrs to inc time by each loop; RTC means use clock */
@@ -73,6 +75,7 @@ static void print_spause();
 static void toggle_body ();
 int set_app_color();
 static void usage(char *why);
+static int save_frames(int wmc, int ac, char *av[]);
 #ifdef NCURSES_LARGE
 void _init_fields();
 void sky_dome_labels();
@@ -111,6 +114,9 @@ char *av[];
 #ifdef ANSI_COLORS
     init_app_colors();
 #endif
+#ifdef PROFILE
+    prof_init();
+#endif
 
     while ((--ac > 0) && (**++av == '-'))
     {
@@ -122,6 +128,14 @@ char *av[];
                 if (--ac <= 0) usage("-W but no mode");
                 watchmode = *++av;
                 break;
+            case 'F': /* save frames of the -W view, no screen */
+                if (--ac <= 0) usage("-F but no frame count");
+                nframes = atoi(*++av);
+                break;
+            case 'o': /* file for the -F frames */
+                if (--ac <= 0) usage("-o but no frame file");
+                framefile = *++av;
+                break;
             case 'c': /* set name of config file to use */
                 if (--ac <= 0) usage("-c but no config file");
                 cfgfile = *++av;
@@ -147,6 +161,10 @@ char *av[];
                    "Where m is 1-5; 1=Sky Dome 2=AltAz 3=Solar Sys 4=Earth 5=Moon");
     }
 
+    /* just save frames, without ever using the screen */
+    if (nframes)
+        exit (save_frames (watch_mode_code, ac, av));
+
     if (!sflag)
         credits();
 
@@ -180,10 +198,18 @@ char *av[];
     /* update screen forever (until QUIT) */
     while (main_menu_loop)
     {
+#ifdef PROFILE
+        prof_poll();
+#endif
 
         /* if get a floating error, longjmp() here and stop looping */
         if (setjmp (fpe_err_jmp))
+        {
             nstep = 0;
+#ifdef PROFILE
+            prof_unwind();
+#endif
+        }
         else
         {
             nstep -= 1;
@@ -213,7 +239,7 @@ char *av[];
          * or if op hits any key.
          */
         newcir = 0;
-        if (srchdone || nstep <= 0 || (chk_char()==0 && read_char()!=0))
+        if (srchdone || nstep <= 0 || (chk_event()==0 && read_char()!=0))
         {
             int nfld;
 
@@ -388,6 +414,8 @@ int how_much;
 void
 bye()
 {
+    plot_close();
+    listing_close();
     c_erase();
     byetty();
 #ifdef NCURSES_LARGE
@@ -421,6 +449,7 @@ char *why;
 #ifdef _CIRCUM_H
         "[-W m] "
 #endif
+        "[-F <frames> [-o <file>]] "
         "[-c <configfile>] [-d <database>] [field=value ...]\r\n";
     f_string (2, 1, msg );
     byetty();
@@ -431,6 +460,46 @@ char *why;
     exit (1);
 }
 
+/* draw nframes of watch view wmc-1 offscreen, stepping by StpSz, and write
+ * them to framefile, or stdout. the config file and field args are read as
+ * usual but anything they would draw goes to a scratch screen, so no tty is
+ * used at all. return the exit status.
+ */
+static int
+save_frames (wmc, ac, av)
+int wmc;
+int ac;
+char *av[];
+{
+    char *scratch;
+    char why[128];
+
+    if (!wmc)
+    {
+        (void) fprintf (stderr, "-F needs a view from -W\n");
+        return (1);
+    }
+
+    scratch = malloc (NR*NC);
+    if (!scratch)
+    {
+        (void) fprintf (stderr, "No memory\n");
+        return (1);
+    }
+    c_offscreen (scratch);
+    read_cfgfile ();
+    read_fieldargs (ac, av);
+    c_offscreen ((char *)0);
+    free (scratch);
+
+    if (watch_frames (wmc-1, &now, tminc, oppl, nframes, framefile, why) < 0)
+    {
+        (void) fprintf (stderr, "%s\n", why);
+        return (1);
+    }
+    return (0);
+}
+
 /* process the field specs from the command line.
  * if trouble call usage() (which exits).
  */
@@ -486,7 +555,9 @@ char *buf;
         /* 14 */	"OBJX",
         /* 15 */	"OBJY",
         /* 16 */	"PROPTS",
-        /* 17 */	"MENU"
+        /* 17 */	"MENU",
+        /* 18 */	"STARS",
+        /* 19 */	"STMAG"
     };
     int i;
     int l;
@@ -610,6 +681,12 @@ char *buf;
         else if (strncmp (buf, "JUP", 3) == 0)
             altmenu_init (F_MNUJ);
         break;
+    case 18:
+        stars_setfilename (buf);
+        break;
+    case 19:
+        stars_setmag (atof (buf));
+        break;
     default:
         return (-1);
     }
@@ -1021,6 +1098,12 @@ int *fld;
          */
         set_t0 (&now);
         M_BREAK;
+        M_CASE( rcfpack (R_JEVENTS, C_JEVENTS, 0) )
+        jm_events_setup (&now);
+        M_BREAK;
+        M_CASE( rcfpack (R_CAL, C_CAL, 0) )
+        yearcal_setup (&now);
+        M_BREAK;
         M_CASE( rcfpack (R_DAWN, C_DAWN, 0) )
         if (optwi ^= 1)
         {
@@ -1268,28 +1351,18 @@ int force;
 /* if not plotting/listing/searching then sleep spause seconds.
  * if time is being based on the real-time clock, sync on the next
  *   integral multiple of spause seconds after the minute.
- * check for keyboard action once each second to let it break out early.
+ * any keyboard action breaks out early.
  */
 void slp_sync()
 {
-    extern long time();
-
     if (spause > 0 && !plot_ison() && !srch_ison() && !listing_ison())
     {
-        int n;
+        double n;
         if (tminc == RTC)
-        {
-            long t;
-            (void) time (&t);
-            n = spause - (t % spause);
-        }
+            n = spause - fmod (time_real(), (double)spause);
         else
             n = spause;
-        while (--n >= 0)
-            if (chk_char() == 0)
-                break;
-            else
-                (void) sleep (1);
+        (void) wait_char (n);
     }
 }
 
@@ -1310,9 +1383,20 @@ int p;
 /* state needed for sky dome redraw */
 int LastSkyStyle;
 Now *Last_np;
-/* handle SIGWINCH for screen resize */
+static volatile sig_atomic_t winch_pending;
+
+/* handle SIGWINCH for screen resize.
+ * just note it; the redraw is done by chk_event() at a safe point.
+ */
 void handle_winch(sig)
 int sig;
+{
+    winch_pending = 1;
+}
+
+/* redraw for a new screen size */
+static void
+do_winch()
 {
     /* ncurses re-inits */
     endwin();
@@ -1322,17 +1406,41 @@ int sig;
     _init_fields();
 
     c_erase();
+#ifdef GLOBE_PHOON
+    putmoon_forget();
+#endif
 
     /* redraw labels, screen */
     if ( ! watching )
         redraw_screen(2);
     else if ( LastSkyStyle == 0 )
         sky_dome_labels( LastSkyStyle, Last_np );
-
-    /* reset SIGWINCH handling */
-    memset(&sa, 0, sizeof(struct sigaction));
-    sa.sa_handler = handle_winch;
-    sigaction(SIGWINCH, &sa, NULL);
 }
 #endif
 
+/* redraw for a new screen size if there has been one since last time.
+ * called wherever it is safe to draw: between steps, and by read_char()
+ * when its wait for a key is interrupted.
+ */
+void chk_winch()
+{
+#ifdef NCURSES_LARGE
+    if (winch_pending)
+    {
+        winch_pending = 0;
+        do_winch();
+    }
+#endif
+}
+
+/* check for anything that has happened while a display is running: a new
+ * screen size is dealt with right here, then return 0 if there is a char
+ * waiting to be read, else -1.
+ * this is called once per step so it must be cheap; see chk_char().
+ */
+int chk_event()
+{
+    chk_winch();
+    return (chk_char());
+}
+
@@ -72,7 +72,7 @@ void mm_labels()
 }
 
 static void mm_calendar (Now *np, int force);
-static void mm_nfmoon (double jd, double tzone, int m, int f);
+static void mm_nfmoon (double jd0, int nd, double tzone, int f);
 
 /* print all the time/date/where related stuff: the Now structure.
  * print in a nice order, based on the field locations, as much as possible.
@@ -244,37 +244,33 @@ int force;
         f_string (R_CAL+2+r, C_CAL, row);
     }
 
-    /* over print the new and full moons for this month.
-     * TODO: don't really know which dates to use here (see moonnf())
-     *   so try several to be fairly safe. have to go back to 4/29/1988
-     *   to find the full moon on 5/1 for example.
-     */
-    mm_nfmoon (jd0-3, tz, m, f);
-    mm_nfmoon (jd0+15, tz, m, f);
+    /* over print the new and full moons for this month */
+    mm_nfmoon (jd0, nd, tz, f);
 }
 
+/* over print the new and full moons on the calendar for the nd local days
+ * starting at jd0, whose first day is in column f.
+ */
 static
-void mm_nfmoon (jd, tzone, m, f)
-double jd, tzone;
-int m, f;
+void mm_nfmoon (jd0, nd, tzone, f)
+double jd0;
+int nd;
+double tzone;
+int f;
 {
     static char nm[] = "NM", fm[] = "FM";
-    double dm;
+    double start = jd0 + tzone/24.0;	/* local midnight, as UT */
+    double dm, t;
     int mm, ym;
-    double jdn, jdf;
+    long q;
     int di;
 
-    moonnf (jd, &jdn, &jdf);
-    mjd_cal (jdn-tzone/24.0, &mm, &dm, &ym);
-    if (m == mm)
-    {
-        di = dm + f - 1;
-        f_string (R_CAL+2+di/7, C_CAL+3*(di%7), nm);
-    }
-    mjd_cal (jdf-tzone/24.0, &mm, &dm, &ym);
-    if (m == mm)
+    for (q = mph_seed (start, &t); t < start + nd; t = mph_time (++q))
     {
+        if (q & 1)
+            continue;	/* a quarter */
+        mjd_cal (t-tzone/24.0, &mm, &dm, &ym);
         di = dm + f - 1;
-        f_string (R_CAL+2+di/7, C_CAL+3*(di%7), fm);
+        f_string (R_CAL+2+di/7, C_CAL+3*(di%7), (q & 3) ? fm : nm);
     }
 }
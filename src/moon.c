@@ -3,6 +3,111 @@
 #include "astro.h"
 #include "ephem.h"
 
+/* the periodic terms of the series for longitude, latitude and parallax.
+ * each is coef * e**ne * sin (or cos) of the sum of multiples kd*de, kms*ms,
+ *   kmd*md and kf*f of the fundamental arguments, largest first much as
+ *   in the published series.
+ */
+typedef struct
+{
+    double coef;
+    short ne;			/* power of e, 0..2 */
+    short k[4];			/* multiples of de, ms, md, f */
+} MTerm;
+
+#define	MH	4		/* largest multiple of any argument, above */
+#define	NMARGS	4		/* de, ms, md, f */
+
+/* sines and cosines of k*x for k = -MH..MH, kept at [k+MH] */
+typedef struct
+{
+    double s[2*MH+1], c[2*MH+1];
+} MHarm;
+
+static MTerm lterms[] =
+{
+    {6.28875, 0, {0, 0, 1, 0}},     {1.27402, 0, {2, 0, -1, 0}},
+    {.658309, 0, {2, 0, 0, 0}},     {.213616, 0, {0, 0, 2, 0}},
+    {-.185596, 1, {0, 1, 0, 0}},    {-.114336, 0, {0, 0, 0, 2}},
+    {.058793, 0, {2, 0, -2, 0}},    {.057212, 1, {2, -1, -1, 0}},
+    {.05332, 0, {2, 0, 1, 0}},      {.045874, 1, {2, -1, 0, 0}},
+    {.041024, 1, {0, -1, 1, 0}},    {-.034718, 0, {1, 0, 0, 0}},
+    {-.030465, 1, {0, 1, 1, 0}},    {.015326, 0, {2, 0, 0, -2}},
+    {-.012528, 0, {0, 0, 1, 2}},    {-.01098, 0, {0, 0, -1, 2}},
+    {.010674, 0, {4, 0, -1, 0}},    {.010034, 0, {0, 0, 3, 0}},
+    {.008548, 0, {4, 0, -2, 0}},    {-.00791, 1, {2, 1, -1, 0}},
+    {-.006783, 1, {2, 1, 0, 0}},    {.005162, 0, {-1, 0, 1, 0}},
+    {.005, 1, {1, 1, 0, 0}},        {.003862, 0, {4, 0, 0, 0}},
+    {.004049, 1, {2, -1, 1, 0}},    {.003996, 0, {2, 0, 2, 0}},
+    {.003665, 0, {2, 0, -3, 0}},    {.002695, 1, {0, -1, 2, 0}},
+    {.002602, 0, {-2, 0, 1, -2}},   {.002396, 1, {2, -1, -2, 0}},
+    {-.002349, 0, {1, 0, 1, 0}},    {.002249, 2, {2, -2, 0, 0}},
+    {-.002125, 1, {0, 1, 2, 0}},    {-.002079, 2, {0, 2, 0, 0}},
+    {.002059, 2, {2, -2, -1, 0}},   {-.001773, 0, {2, 0, 1, -2}},
+    {-.001595, 0, {2, 0, 0, 2}},    {.00122, 1, {4, -1, -1, 0}},
+    {-.00111, 0, {0, 0, 2, 2}},     {.000892, 0, {-3, 0, 1, 0}},
+    {-.000811, 1, {2, 1, 1, 0}},    {.000761, 1, {4, -1, -2, 0}},
+    {.000704, 2, {-2, -2, 1, 0}},   {.000693, 1, {2, 1, -2, 0}},
+    {.000598, 1, {2, -1, 0, -2}},   {.00055, 0, {4, 0, 1, 0}},
+    {.000538, 0, {0, 0, 4, 0}},     {.000521, 1, {4, -1, 0, 0}},
+    {.000486, 0, {-1, 0, 2, 0}},    {.000717, 2, {0, -2, 1, 0}},
+};
+
+static MTerm bterms[] =
+{
+    {5.12819, 0, {0, 0, 0, 1}},     {.280606, 0, {0, 0, 1, 1}},
+    {.277693, 0, {0, 0, 1, -1}},    {.173238, 0, {2, 0, 0, -1}},
+    {.055413, 0, {2, 0, -1, 1}},    {.046272, 0, {2, 0, -1, -1}},
+    {.032573, 0, {2, 0, 0, 1}},     {.017198, 0, {0, 0, 2, 1}},
+    {.009267, 0, {2, 0, 1, -1}},    {.008823, 0, {0, 0, 2, -1}},
+    {.008247, 1, {2, -1, 0, -1}},   {.004323, 0, {2, 0, -2, -1}},
+    {.0042, 0, {2, 0, 1, 1}},       {.003372, 1, {-2, -1, 0, 1}},
+    {.002472, 1, {2, -1, -1, 1}},   {.002222, 1, {2, -1, 0, 1}},
+    {.002072, 1, {2, -1, -1, -1}},  {.001877, 1, {0, -1, 1, 1}},
+    {.001828, 0, {4, 0, -1, -1}},   {-.001803, 1, {0, 1, 0, 1}},
+    {-.00175, 0, {0, 0, 0, 3}},     {.00157, 1, {0, -1, 1, -1}},
+    {-.001487, 0, {1, 0, 0, 1}},    {-.001481, 1, {0, 1, 1, 1}},
+    {.001417, 1, {0, -1, -1, 1}},   {.00135, 1, {0, -1, 0, 1}},
+    {.00133, 0, {-1, 0, 0, 1}},     {.001106, 0, {0, 0, 3, 1}},
+    {.00102, 0, {4, 0, 0, -1}},     {.000833, 0, {4, 0, -1, 1}},
+    {.000781, 0, {0, 0, 1, -3}},    {.00067, 0, {4, 0, -2, 1}},
+    {.000606, 0, {2, 0, 0, -3}},    {.000597, 0, {2, 0, 2, -1}},
+    {.000492, 1, {2, -1, 1, -1}},   {.00045, 0, {-2, 0, 2, -1}},
+    {.000439, 0, {0, 0, 3, -1}},    {.000423, 0, {2, 0, 2, 1}},
+    {.000422, 0, {2, 0, -3, -1}},   {-.000367, 1, {2, 1, -1, 1}},
+    {-.000353, 1, {2, 1, 0, 1}},    {.000331, 0, {4, 0, 0, 1}},
+    {.000317, 1, {2, -1, 1, 1}},    {.000306, 2, {2, -2, 0, -1}},
+    {-.000283, 0, {0, 0, 1, 3}},
+};
+
+/* these are cosines, added to .950724 */
+static MTerm pterms[] =
+{
+    {.051818, 0, {0, 0, 1, 0}},     {.009531, 0, {2, 0, -1, 0}},
+    {.007843, 0, {2, 0, 0, 0}},     {.002824, 0, {0, 0, 2, 0}},
+    {.000857, 0, {2, 0, 1, 0}},     {.000533, 1, {2, -1, 0, 0}},
+    {.000401, 1, {2, -1, -1, 0}},   {.00032, 1, {0, -1, 1, 0}},
+    {-.000271, 0, {1, 0, 0, 0}},    {-.000264, 1, {0, 1, 1, 0}},
+    {-.000198, 0, {0, 0, -1, 2}},   {.000173, 0, {0, 0, 3, 0}},
+    {.000167, 0, {4, 0, -1, 0}},    {-.000111, 1, {0, 1, 0, 0}},
+    {.000103, 0, {4, 0, -2, 0}},    {-.000084, 0, {-2, 0, 2, 0}},
+    {-.000083, 1, {2, 1, 0, 0}},    {.000079, 0, {2, 0, 2, 0}},
+    {.000072, 0, {4, 0, 0, 0}},     {.000064, 1, {2, -1, 1, 0}},
+    {-.000063, 1, {2, 1, -1, 0}},   {.000041, 1, {1, 1, 0, 0}},
+    {.000035, 1, {0, -1, 2, 0}},    {-.000033, 0, {-2, 0, 3, 0}},
+    {-.00003, 0, {1, 0, 1, 0}},     {-.000029, 0, {-2, 0, 0, 2}},
+    {-.000029, 1, {0, 1, 2, 0}},    {.000026, 2, {2, -2, 0, 0}},
+    {-.000023, 0, {-2, 0, 1, 2}},   {.000019, 1, {4, -1, -1, 0}},
+};
+
+#define	NLTERMS	(sizeof(lterms)/sizeof(lterms[0]))
+#define	NBTERMS	(sizeof(bterms)/sizeof(bterms[0]))
+#define	NPTERMS	(sizeof(pterms)/sizeof(pterms[0]))
+
+static void mharm (double x, MHarm *hp);
+static double mseries (MTerm *tp, int n, MHarm h[NMARGS], double ep[3],
+                       int cosine);
+
 /* given the mjd, find the geocentric ecliptic longitude, lam, and latitude,
  * bet, and horizontal parallax, hp for the moon.
  * N.B. series for long and lat are good to about 10 and 3 arcseconds. however,
@@ -10,6 +115,10 @@
  *   why?? suspect highly sensitive nature of difference used to get m1..6.
  * N.B. still need to correct for nutation. then for topocentric location
  *   further correct for parallax and refraction.
+ * the series are held in the tables above. each term is found from the
+ *   sines and cosines of the few multiples of de, ms, md and f they use, which
+ *   are computed just once here, so there are 8 calls to sin() and cos()
+ *   for the series rather than one for each of its 125 terms.
  */
 void moon (mjd, lam, bet, hp)
 double mjd;
@@ -24,7 +133,10 @@ double *lam, *bet, *hp;
     double n;
     double a, sa, sn, b, sb, c, sc, e, e2, l, g, w1, w2;
     double m1, m2, m3, m4, m5, m6;
+    MHarm h[NMARGS];
+    double ep[3];
 
+    PROF_IN(PF_MOON);
     t = mjd/36525.;
     t2 = t*t;
 
@@ -70,67 +182,104 @@ double *lam, *bet, *hp;
     f = degrad(f);
     md = degrad(md);
 
-    l = 6.28875*sin(md)+1.27402*sin(2*de-md)+.658309*sin(2*de)+
-        .213616*sin(2*md)-e*.185596*sin(ms)-.114336*sin(2*f)+
-        .058793*sin(2*(de-md))+.057212*e*sin(2*de-ms-md)+
-        .05332*sin(2*de+md)+.045874*e*sin(2*de-ms)+.041024*e*sin(md-ms);
-    l = l-.034718*sin(de)-e*.030465*sin(ms+md)+.015326*sin(2*(de-f))-
-        .012528*sin(2*f+md)-.01098*sin(2*f-md)+.010674*sin(4*de-md)+
-        .010034*sin(3*md)+.008548*sin(4*de-2*md)-e*.00791*sin(ms-md+2*de)-
-        e*.006783*sin(2*de+ms);
-    l = l+.005162*sin(md-de)+e*.005*sin(ms+de)+.003862*sin(4*de)+
-        e*.004049*sin(md-ms+2*de)+.003996*sin(2*(md+de))+
-        .003665*sin(2*de-3*md)+e*.002695*sin(2*md-ms)+
-        .002602*sin(md-2*(f+de))+e*.002396*sin(2*(de-md)-ms)-
-        .002349*sin(md+de);
-    l = l+e2*.002249*sin(2*(de-ms))-e*.002125*sin(2*md+ms)-
-        e2*.002079*sin(2*ms)+e2*.002059*sin(2*(de-ms)-md)-
-        .001773*sin(md+2*(de-f))-.001595*sin(2*(f+de))+
-        e*.00122*sin(4*de-ms-md)-.00111*sin(2*(md+f))+.000892*sin(md-3*de);
-    l = l-e*.000811*sin(ms+md+2*de)+e*.000761*sin(4*de-ms-2*md)+
-        e2*.000704*sin(md-2*(ms+de))+e*.000693*sin(ms-2*(md-de))+
-        e*.000598*sin(2*(de-f)-ms)+.00055*sin(md+4*de)+.000538*sin(4*md)+
-        e*.000521*sin(4*de-ms)+.000486*sin(2*md-de);
-    l = l+e2*.000717*sin(md-2*ms);
+    mharm (de, &h[0]);
+    mharm (ms, &h[1]);
+    mharm (md, &h[2]);
+    mharm (f, &h[3]);
+    ep[0] = 1;
+    ep[1] = e;
+    ep[2] = e2;
+
+    l = mseries (lterms, NLTERMS, h, ep, 0);
     *lam = ld+degrad(l);
     range (lam, 2*PI);
 
-    g = 5.12819*sin(f)+.280606*sin(md+f)+.277693*sin(md-f)+
-        .173238*sin(2*de-f)+.055413*sin(2*de+f-md)+.046272*sin(2*de-f-md)+
-        .032573*sin(2*de+f)+.017198*sin(2*md+f)+.009267*sin(2*de+md-f)+
-        .008823*sin(2*md-f)+e*.008247*sin(2*de-ms-f);
-    g = g+.004323*sin(2*(de-md)-f)+.0042*sin(2*de+f+md)+
-        e*.003372*sin(f-ms-2*de)+e*.002472*sin(2*de+f-ms-md)+
-        e*.002222*sin(2*de+f-ms)+e*.002072*sin(2*de-f-ms-md)+
-        e*.001877*sin(f-ms+md)+.001828*sin(4*de-f-md)-e*.001803*sin(f+ms)-
-        .00175*sin(3*f);
-    g = g+e*.00157*sin(md-ms-f)-.001487*sin(f+de)-e*.001481*sin(f+ms+md)+
-        e*.001417*sin(f-ms-md)+e*.00135*sin(f-ms)+.00133*sin(f-de)+
-        .001106*sin(f+3*md)+.00102*sin(4*de-f)+.000833*sin(f+4*de-md)+
-        .000781*sin(md-3*f)+.00067*sin(f+4*de-2*md);
-    g = g+.000606*sin(2*de-3*f)+.000597*sin(2*(de+md)-f)+
-        e*.000492*sin(2*de+md-ms-f)+.00045*sin(2*(md-de)-f)+
-        .000439*sin(3*md-f)+.000423*sin(f+2*(de+md))+
-        .000422*sin(2*de-f-3*md)-e*.000367*sin(ms+f+2*de-md)-
-        e*.000353*sin(ms+f+2*de)+.000331*sin(f+4*de);
-    g = g+e*.000317*sin(2*de+f-ms+md)+e2*.000306*sin(2*(de-ms)-f)-
-        .000283*sin(md+3*f);
+    g = mseries (bterms, NBTERMS, h, ep, 0);
     w1 = .0004664*cos(n);
     w2 = .0000754*cos(c);
     *bet = degrad(g)*(1-w1-w2);
 
-    *hp = .950724+.051818*cos(md)+.009531*cos(2*de-md)+.007843*cos(2*de)+
-          .002824*cos(2*md)+.000857*cos(2*de+md)+e*.000533*cos(2*de-ms)+
-          e*.000401*cos(2*de-md-ms)+e*.00032*cos(md-ms)-.000271*cos(de)-
-          e*.000264*cos(ms+md)-.000198*cos(2*f-md);
-    *hp = *hp+.000173*cos(3*md)+.000167*cos(4*de-md)-e*.000111*cos(ms)+
-          .000103*cos(4*de-2*md)-.000084*cos(2*md-2*de)-
-          e*.000083*cos(2*de+ms)+.000079*cos(2*de+2*md)+.000072*cos(4*de)+
-          e*.000064*cos(2*de-ms+md)-e*.000063*cos(2*de+ms-md)+
-          e*.000041*cos(ms+de);
-    *hp = *hp+e*.000035*cos(2*md-ms)-.000033*cos(3*md-2*de)-
-          .00003*cos(md+de)-.000029*cos(2*(f-de))-e*.000029*cos(2*md+ms)+
-          e2*.000026*cos(2*(de-ms))-.000023*cos(2*(f-de)+md)+
-          e*.000019*cos(4*de-ms-md);
+    *hp = .950724+mseries (pterms, NPTERMS, h, ep, 1);
     *hp = degrad(*hp);
+    PROF_OUT(PF_MOON);
+}
+
+/* find moon() for each of the n dates mjd[], into lam[], bet[] and hp[] */
+void moon_n (mjd, n, lam, bet, hp)
+double mjd[];
+int n;
+double lam[], bet[], hp[];
+{
+    int i;
+
+    for (i = 0; i < n; i++)
+        moon (mjd[i], &lam[i], &bet[i], &hp[i]);
+}
+
+/* fill in h with the sines and cosines of the multiples of x used in the
+ * series. only sin(x) and cos(x) come from the math library; the rest
+ * follow by angle addition.
+ */
+static void
+mharm (x, hp)
+double x;
+MHarm *hp;
+{
+    double sx = sin(x), cx = cos(x);
+    int k;
+
+    hp->s[MH] = 0.0;
+    hp->c[MH] = 1.0;
+    for (k = 1; k <= MH; k++)
+    {
+        double s = hp->s[MH+k-1]*cx + hp->c[MH+k-1]*sx;
+        double c = hp->c[MH+k-1]*cx - hp->s[MH+k-1]*sx;
+
+        hp->s[MH+k] = s;
+        hp->c[MH+k] = c;
+        hp->s[MH-k] = -s;
+        hp->c[MH-k] = c;
+    }
+}
+
+/* sum the n terms at tp, each the sine (or cosine if cosine is set) of its
+ * combination of the arguments in h[], scaled by its coefficient and by
+ * ep[] indexed by its power of e.
+ * the sine and cosine of the combination are built up by angle addition
+ * from those of each argument's multiple, so no term calls the library.
+ */
+static double
+mseries (tp, n, h, ep, cosine)
+MTerm *tp;
+int n;
+MHarm h[NMARGS];
+double ep[3];
+int cosine;
+{
+    double *k0s = &h[0].s[MH], *k0c = &h[0].c[MH];
+    double *k1s = &h[1].s[MH], *k1c = &h[1].c[MH];
+    double *k2s = &h[2].s[MH], *k2c = &h[2].c[MH];
+    double *k3s = &h[3].s[MH], *k3c = &h[3].c[MH];
+    double sum = 0;
+
+    for (; n > 0; --n, tp++)
+    {
+        double s0 = k0s[tp->k[0]], c0 = k0c[tp->k[0]];
+        double s1 = k1s[tp->k[1]], c1 = k1c[tp->k[1]];
+        double s2 = k2s[tp->k[2]], c2 = k2c[tp->k[2]];
+        double s3 = k3s[tp->k[3]], c3 = k3c[tp->k[3]];
+        double sa, ca, sb, cb;
+
+        /* combine the four in pairs, then the pairs */
+        sa = s0*c1 + c0*s1;
+        ca = c0*c1 - s0*s1;
+        sb = s2*c3 + c2*s3;
+        cb = c2*c3 - s2*s3;
+        if (cosine)
+            sum += tp->coef*ep[tp->ne]*(ca*cb - sa*sb);
+        else
+            sum += tp->coef*ep[tp->ne]*(sa*cb + ca*sb);
+    }
+
+    return (sum);
 }
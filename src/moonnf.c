@@ -3,9 +3,7 @@
 #include "astro.h"
 #include "ephem.h"
 
-#define	unw(w,z)	((w)-floor((w)/(z))*(z))
-
-static void m (double t, double k, double *mjd);
+#define	SYNMONTH	29.53058868	/* mean new moon to new moon, days */
 
 /* given a modified Julian date, mjd, return the mjd of the new
  * and full moons about then, mjdn and mjdf.
@@ -20,50 +18,101 @@ double *mjdn, *mjdf;
     int mo, yr;
     double dy;
     double mjd0;
-    double k, tn, tf, t;
+    double k;
 
     mjd_cal (mjd, &mo, &dy, &yr);
     cal_mjd (1, 0., yr, &mjd0);
     k = (yr-1900+((mjd-mjd0)/365))*12.3685;
     k = floor(k+0.5);
-    tn = k/1236.85;
-    tf = (k+0.5)/1236.85;
-    t = tn;
-    m (t, k, mjdn);
-    t = tf;
-    k += 0.5;
-    m (t, k, mjdf);
+    *mjdn = mph_time ((long)k*4);
+    *mjdf = mph_time ((long)k*4+2);
 }
 
-static
-void m (t, k, mjd)
-double t, k;
-double *mjd;
+/* return the mjd of quarter phase q, counted from the new moon of
+ * 1900 Jan 0.5: q&3 is 0 for new, 1 first quarter, 2 full, 3 last quarter.
+ * from Meeus, Astronomical Formulae for Calculators, as is truephase() in
+ * phoonastro.c.
+ */
+double mph_time (q)
+long q;
 {
-    double t2, a, a1, b, b1, c, ms, mm, f, ddjd;
+    double k, t, t2, t3, pt, ms, mm, f;
 
+    k = q/4.0;
+    t = k/1236.85;
     t2 = t*t;
-    a = 29.53*k;
-    c = degrad(166.56+(132.87-9.173e-3*t)*t);
-    b = 5.8868e-4*k+(1.178e-4-1.55e-7*t)*t2+3.3e-4*sin(c)+7.5933E-1;
-    ms = 359.2242+360*unw(k/1.236886e1,1)-(3.33e-5+3.47e-6*t)*t2;
-    mm = 306.0253+360*unw(k/9.330851e-1,1)+(1.07306e-2+1.236e-5*t)*t2;
-    f = 21.2964+360*unw(k/9.214926e-1,1)-(1.6528e-3+2.39e-6*t)*t2;
-    ms = unw(ms,360);
-    mm = unw(mm,360);
-    f = unw(f,360);
-    ms = degrad(ms);
-    mm = degrad(mm);
-    f = degrad(f);
-    ddjd = (1.734e-1-3.93e-4*t)*sin(ms)+2.1e-3*sin(2*ms)
-           -4.068e-1*sin(mm)+1.61e-2*sin(2*mm)-4e-4*sin(3*mm)
-           +1.04e-2*sin(2*f)-5.1e-3*sin(ms+mm)-7.4e-3*sin(ms-mm)
-           +4e-4*sin(2*f+ms)-4e-4*sin(2*f-ms)-6e-4*sin(2*f+mm)
-           +1e-3*sin(2*f-mm)+5e-4*sin(ms+2*mm);
-    a1 = (long)a;
-    b = b+ddjd+(a-a1);
-    b1 = (long)b;
-    a = a1+b1;
-    b = b-b1;
-    *mjd = a + b;
+    t3 = t2*t;
+    pt = 0.75933 + SYNMONTH*k + 1.178e-4*t2 - 1.55e-7*t3
+         + 3.3e-4*sin(degrad(166.56+132.87*t-9.173e-3*t2));
+
+    ms = degrad(359.2242+29.10535608*k-3.33e-5*t2-3.47e-6*t3);
+    mm = degrad(306.0253+385.81691806*k+1.07306e-2*t2+1.236e-5*t3);
+    f = degrad(21.2964+390.67050646*k-1.6528e-3*t2-2.39e-6*t3);
+
+    if ((q & 1) == 0)
+    {
+        /* new and full */
+        pt += (1.734e-1-3.93e-4*t)*sin(ms)+2.1e-3*sin(2*ms)
+              -4.068e-1*sin(mm)+1.61e-2*sin(2*mm)-4e-4*sin(3*mm)
+              +1.04e-2*sin(2*f)-5.1e-3*sin(ms+mm)-7.4e-3*sin(ms-mm)
+              +4e-4*sin(2*f+ms)-4e-4*sin(2*f-ms)-6e-4*sin(2*f+mm)
+              +1e-3*sin(2*f-mm)+5e-4*sin(ms+2*mm);
+    }
+    else
+    {
+        /* quarters */
+        double qc = 2.8e-3-4e-4*cos(ms)+3e-4*cos(mm);
+        pt += (1.721e-1-4e-4*t)*sin(ms)+2.1e-3*sin(2*ms)
+              -6.28e-1*sin(mm)+8.9e-3*sin(2*mm)-4e-4*sin(3*mm)
+              +7.9e-3*sin(2*f)-1.19e-2*sin(ms+mm)-4.7e-3*sin(ms-mm)
+              +3e-4*sin(2*f+ms)-4e-4*sin(2*f-ms)-6e-4*sin(2*f+mm)
+              +2.1e-3*sin(2*f-mm)+3e-4*sin(ms+2*mm)+4e-4*sin(ms-2*mm)
+              -3e-4*sin(2*ms+mm);
+        pt += (q & 3) == 1 ? qc : -qc;
+    }
+
+    return (pt);
+}
+
+/* seed a walk through the phases of the moon: return the q, as used by
+ * mph_time(), of the first quarter phase at or after mjd and put its time
+ * in *mjdp. after this each successive phase costs just mph_time(++q).
+ */
+long mph_seed (mjd, mjdp)
+double mjd;
+double *mjdp;
+{
+    long q;
+    double t;
+
+    /* start one before the mean phase; the true one is within a day */
+    q = (long)floor((mjd - 0.75933)/(SYNMONTH/4)) - 1;
+    while ((t = mph_time(q)) < mjd)
+        q++;
+    *mjdp = t;
+    return (q);
+}
+
+/* fill mjds[] with the times and which[] with q&3 of each quarter phase of
+ * the moon from mjd0 up to but not including mjd1, at most max of them.
+ * return the number found.
+ */
+int mph_list (mjd0, mjd1, mjds, which, max)
+double mjd0, mjd1;
+double mjds[];
+int which[];
+int max;
+{
+    long q;
+    double t;
+    int n;
+
+    q = mph_seed (mjd0, &t);
+    for (n = 0; n < max && t < mjd1; n++)
+    {
+        mjds[n] = t;
+        which[n] = (int)(q & 3);
+        t = mph_time (++q);
+    }
+    return (n);
 }
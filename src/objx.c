@@ -8,6 +8,12 @@
 #include <string.h>
 #include <math.h>
 #include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
 #ifdef VMS
 #include <stdlib.h>
 #endif
@@ -35,6 +41,9 @@ typedef struct
     double f_siz;	/* angular size, in arc seconds */
     double f_epoch;	/* the given epoch, as an mjd */
     char   f_name[MAXNM]; /* name */
+    int    f_vok;	/* !=0 once f_v is set */
+    double f_vra, f_vdec; /* f_ra and f_dec f_v was made from */
+    double f_v[3];	/* equatorial unit vector at f_epoch */
 } ObjF;			/* fixed object */
 typedef struct
 {
@@ -77,6 +86,24 @@ typedef struct
     char   p_name[MAXNM]; /* name */
 } ObjP;			/* object in heliocentric parabolic trajectory */
 
+/* the orbital elements that change with the equinox, reduced from their own
+ * epoch to a date on a grid RED_TOL days apart, with what they came from.
+ * obj_cir() uses the reduction for the grid date nearest the one it wants;
+ * in RED_TOL/2 days precession moves the node only about .07 arc seconds.
+ * so reduce_elements() is called only once every RED_TOL days of a long
+ * tabulation, or when the elements themselves change.
+ */
+#define	RED_TOL		1.0
+typedef struct
+{
+    int    r_ok;	/* !=0 once the rest is set */
+    double r_epoch;	/* equinox of the given elements, as an mjd */
+    double r_inc0, r_om0, r_Om0; /* the given elements, degrees */
+    double r_mjd;	/* grid date they were reduced to */
+    double r_inc, r_om, r_Om; /* the reduced elements, rads */
+    double r_sinc, r_cinc; /* sin and cos of r_inc */
+} RedElts;
+
 typedef struct
 {
     int  o_type;	/* current object type; see flags, below */
@@ -85,6 +112,7 @@ typedef struct
     ObjE o_e;		/* the elliptical orbit object */
     ObjH o_h;		/* the hyperbolic orbit object */
     ObjP o_p;		/* the parabolic orbit object */
+    RedElts o_red;	/* reduced elements of whichever orbit is in use */
 } Obj;
 
 /* o_type */
@@ -100,10 +128,79 @@ typedef struct
 static Obj objx;
 static Obj objy;
 
+/* one object from the database file, already cracked. */
+typedef struct
+{
+    int d_type;		/* FIXED .. PARABOLIC, as o_type; 0 if line was bad */
+    union
+    {
+        ObjF d_f;
+        ObjE d_e;
+        ObjH d_h;
+        ObjP d_p;
+    } d_u;
+} DbRec;
+
+/* the database file is cracked into an array of DbRecs once, a share of the
+ * lines to each of several processes, and the array is saved after a DbHdr
+ * in a file named with DB_SUFFIX added, followed by the index of each DbRec
+ * in order of name. while the database file keeps the same modification
+ * time and size, later runs just map that in.
+ */
+#define	DB_MAGIC	"ephemdb2"	/* first 8 bytes of the saved array */
+#define	DB_SUFFIX	".bin"
+#define	DB_MAXPROCS	16	/* most processes cracking lines */
+#define	DB_MINLINES	4096	/* fewest lines worth another process */
+#define	DB_MAXLINE	160	/* longest line used; the rest is ignored */
+typedef struct
+{
+    char h_magic[8];	/* DB_MAGIC, no \0 */
+    double h_mtime;	/* modification time of the database file */
+    double h_size;	/* its size, bytes */
+    int h_nrec;		/* number of DbRecs, and then ints, that follow */
+    int h_recsize;	/* sizeof(DbRec) of the program that wrote them */
+    char h_pad[32];	/* keep the DbRecs aligned */
+} DbHdr;
+
+static char *db_fn;		/* name of the database loaded, or 0 */
+static double db_mtime, db_size; /* its modification time and size then */
+static DbRec *db_recs;		/* its objects, in file order */
+static int db_nrec;		/* number of them */
+static int *db_idx;		/* db_recs[] indices by name, ignoring case */
+static int *db_sub;		/* db_recs[] indices of names containing ... */
+static char db_subpat[MAXNM];	/* ... this, from the last db_match() */
+static int db_nsub = -1;	/* number in db_sub[], -1 if none */
+static int db_subroom;		/* room in db_sub[] */
+static char *db_map;		/* mapping db_recs lives in */
+static size_t db_maplen;	/* its size */
+
+/* the matrix that takes an equatorial unit vector at epoch fm_ep to the
+ * ecliptic of date fm_jd, for fixed objects. both objects usually share an
+ * epoch, so each date costs one precess_matrix() between them.
+ */
+static double fm[3][3];
+static double fm_ep = NOMJD, fm_jd = NOMJD;
+
 #define	DY	0		/* decimal year flag for set_year() */
 #define	YMD	1		/* year/mon/day flag for set_year() */
 
-static int nxt_db (char buf[], int blen, FILE *fp);
+static int obj_crack (Obj *op, char *s, char why[]);
+static int db_load (char *fn, char why[]);
+static void db_free (void);
+static int db_mapsaved (char *fn, struct stat *sp);
+static int db_crackall (char *fn, char why[]);
+static void db_crackshare (char *text, long *lines, int w, int nw, int n);
+static void db_save (char *fn);
+static char *db_name (DbRec *dp);
+static int db_sort (void);
+static int db_keycmp (const void *p1, const void *p2);
+static int db_foldcmp (char *s1, char *s2, int n);
+static int db_prefix (char *pat, int *lop);
+static int db_match (char *pat, int **vp);
+static void db_use (Obj *op, DbRec *dp);
+static RedElts *obj_reduce (Obj *op, double ep, double inc, double om,
+                            double Om, double jd);
+static void fixed_matrix (double ep, double jd);
 static void obj_dfixed (Obj *op, int ac, char *av[]);
 static void obj_delliptical(Obj *op, int ac, char *av[]);
 static void obj_dhyperbolic (Obj *op, int ac, char *av[]);
@@ -237,12 +334,26 @@ double *mag;	/* APPARENT magnitude */
     {
     case FIXED:
     {
-        double xr, xd;
-        xr = op->o_f.f_ra;
-        xd = op->o_f.f_dec;
-        if (op->o_f.f_epoch != jd)
-            precess (op->o_f.f_epoch, jd, &xr, &xd);
-        eq_ecl (jd, xr, xd, bet, lam);
+        ObjF *fp = &op->o_f;
+        double *v = fp->f_v;
+        double x, y, z;
+
+        if (!fp->f_vok || fp->f_vra != fp->f_ra || fp->f_vdec != fp->f_dec)
+        {
+            v[0] = cos(fp->f_dec)*cos(fp->f_ra);
+            v[1] = cos(fp->f_dec)*sin(fp->f_ra);
+            v[2] = sin(fp->f_dec);
+            fp->f_vra = fp->f_ra;
+            fp->f_vdec = fp->f_dec;
+            fp->f_vok = 1;
+        }
+        fixed_matrix (fp->f_epoch, jd);
+        x = fm[0][0]*v[0] + fm[0][1]*v[1] + fm[0][2]*v[2];
+        y = fm[1][0]*v[0] + fm[1][1]*v[1] + fm[1][2]*v[2];
+        z = fm[2][0]*v[0] + fm[2][1]*v[1] + fm[2][2]*v[2];
+        *lam = atan2 (y, x);
+        range (lam, 2*PI);
+        *bet = asin (z > 1.0 ? 1.0 : z < -1.0 ? -1.0 : z);
 
         *lpd0 = NOHELIO;
         *psi0 = *rp0 = *rho0 = 0.0;
@@ -262,36 +373,32 @@ double *mag;	/* APPARENT magnitude */
         double dt, lg, lsn, rsn;
         double nu, ea;
         double ma, rp, lo, slo, clo;
-        double inc, psi, spsi, cpsi;
+        double psi, spsi, cpsi;
         double y, lpd, rpd, ll, rho, sll, cll;
-        double om;		/* arg of perihelion */
-        double Om;		/* long of ascending node. */
         double e;
+        RedElts *re;
         int pass;
 
         dt = 0;
         sunpos (jd, &lsn, &rsn);
         lg = lsn + PI;
         e = op->o_e.e_e;
+        re = obj_reduce (op, op->o_e.e_epoch, op->o_e.e_inc, op->o_e.e_om,
+                         op->o_e.e_Om, jd);
 
         for (pass = 0; pass < 2; pass++)
         {
-
-            reduce_elements (op->o_e.e_epoch, jd-dt, degrad(op->o_e.e_inc),
-                             degrad (op->o_e.e_om), degrad (op->o_e.e_Om),
-                             &inc, &om, &Om);
-
             ma = degrad (op->o_e.e_M
                          + (jd - op->o_e.e_cepoch - dt) * op->o_e.e_n);
             anomaly (ma, e, &nu, &ea);
             rp = op->o_e.e_a * (1-e*e) / (1+e*cos(nu));
-            lo = nu + om;
+            lo = nu + re->r_om;
             slo = sin(lo);
             clo = cos(lo);
-            spsi = slo*sin(inc);
-            y = slo*cos(inc);
+            spsi = slo*re->r_sinc;
+            y = slo*re->r_cinc;
             psi = asin(spsi);
-            lpd = atan(y/clo)+Om;
+            lpd = atan(y/clo)+re->r_Om;
             if (clo<0) lpd += PI;
             range (&lpd, 2*PI);
             cpsi = cos(psi);
@@ -346,12 +453,11 @@ double *mag;	/* APPARENT magnitude */
         double dt, lg, lsn, rsn;
         double nu, ea;
         double ma, rp, lo, slo, clo;
-        double inc, psi, spsi, cpsi;
+        double psi, spsi, cpsi;
         double y, lpd, rpd, ll, rho, sll, cll;
-        double om;		/* arg of perihelion */
-        double Om;		/* long of ascending node. */
         double e;
         double a, n;	/* semi-major axis, mean daily motion */
+        RedElts *re;
         int pass;
 
         dt = 0;
@@ -360,24 +466,21 @@ double *mag;	/* APPARENT magnitude */
         e = op->o_h.h_e;
         a = op->o_h.h_qp/(e - 1.0);
         n = .98563/sqrt(a*a*a);
+        re = obj_reduce (op, op->o_h.h_epoch, op->o_h.h_inc, op->o_h.h_om,
+                         op->o_h.h_Om, jd);
 
         for (pass = 0; pass < 2; pass++)
         {
-
-            reduce_elements (op->o_h.h_epoch, jd-dt, degrad(op->o_h.h_inc),
-                             degrad (op->o_h.h_om), degrad (op->o_h.h_Om),
-                             &inc, &om, &Om);
-
             ma = degrad ((jd - op->o_h.h_ep - dt) * n);
             anomaly (ma, e, &nu, &ea);
             rp = a * (e*e-1.0) / (1.0+e*cos(nu));
-            lo = nu + om;
+            lo = nu + re->r_om;
             slo = sin(lo);
             clo = cos(lo);
-            spsi = slo*sin(inc);
-            y = slo*cos(inc);
+            spsi = slo*re->r_sinc;
+            y = slo*re->r_cinc;
             psi = asin(spsi);
-            lpd = atan(y/clo)+Om;
+            lpd = atan(y/clo)+re->r_Om;
             if (clo<0) lpd += PI;
             range (&lpd, 2*PI);
             cpsi = cos(psi);
@@ -410,19 +513,19 @@ double *mag;	/* APPARENT magnitude */
 
     case PARABOLIC:
     {
-        double inc, om, Om;
         double lpd, psi, rp, rho;
         double dt;
+        RedElts *re;
         int pass;
 
         /* two passes to correct lam and bet for light travel time. */
         dt = 0.0;
+        re = obj_reduce (op, op->o_p.p_epoch, op->o_p.p_inc, op->o_p.p_om,
+                         op->o_p.p_Om, jd);
         for (pass = 0; pass < 2; pass++)
         {
-            reduce_elements (op->o_p.p_epoch, jd-dt, degrad(op->o_p.p_inc),
-                             degrad(op->o_p.p_om), degrad(op->o_p.p_Om), &inc, &om, &Om);
-            comet (jd-dt, op->o_p.p_ep, inc, om, op->o_p.p_qp, Om,
-                   &lpd, &psi, &rp, &rho, lam, bet);
+            comet (jd-dt, op->o_p.p_ep, re->r_inc, re->r_om, op->o_p.p_qp,
+                   re->r_Om, &lpd, &psi, &rp, &rho, lam, bet);
             if (pass == 0)
             {
                 *lpd0 = lpd;
@@ -453,12 +556,31 @@ double *mag;	/* APPARENT magnitude */
 int obj_define (p, s)
 int p;	/* OBJX or OBJY */
 char *s;
+{
+    char why[NC];
+
+    if (obj_crack ((p == OBJX) ? &objx : &objy, s, why) < 0)
+    {
+        f_msg (why);
+        return (-1);
+    }
+    return (0);
+}
+
+/* crack the ephem.db line, s, into *op.
+ * N.B. we replace all ',' within s with '\0' IN PLACE.
+ * return 0 if ok, else put reason in why[] and return -1.
+ */
+static int
+obj_crack (op, s, why)
+Obj *op;
+char *s;
+char why[];
 {
 #define	MAXARGS	20
     char *av[MAXARGS];	/* point to each field for easy reference */
     char c;
     int ac;
-    Obj *op = (p == OBJX) ? &objx : &objy;
 
     /* parse into comma separated fields */
     ac = 0;
@@ -469,19 +591,20 @@ char *s;
         if (c == ',' || c == '\0')
         {
             s[-1] = '\0';
-            av[++ac] = s;
+            if (ac < MAXARGS-1)
+                av[++ac] = s;
         }
     }
     while (c);
+    if ((int)strlen(av[0]) >= MAXNM)
+        av[0][MAXNM-1] = '\0';
 
     if (ac < 2)
     {
-        char buf[NC];
         if (ac > 0)
-            (void) sprintf (buf, "No type for Object %s", av[0]);
+            (void) sprintf (why, "No type for Object %s", av[0]);
         else
-            (void) sprintf (buf, "No fields in %s", s);
-        f_msg (buf);
+            (void) sprintf (why, "No fields in %.40s", s);
         return (-1);
     }
 
@@ -491,10 +614,8 @@ char *s;
     case 'f':
         if (ac != 6 && ac != 7)
         {
-            char buf[NC];
-            (void) sprintf(buf,
+            (void) sprintf(why,
                            "Need ra,dec,mag,D[,siz] for fixed object %s", av[0]);
-            f_msg (buf);
             return (-1);
         }
         obj_dfixed (op, ac, av);
@@ -503,11 +624,9 @@ char *s;
     case 'e':
         if (ac != 13 && ac != 14)
         {
-            char buf[NC];
-            (void) sprintf (buf,
+            (void) sprintf (why,
                             "Need i,O,o,a,n,e,M,E,D,H/g,G/k[,siz] for elliptical object %s",
                             av[0]);
-            f_msg (buf);
             return (-1);
         }
         obj_delliptical (op, ac, av);
@@ -516,10 +635,8 @@ char *s;
     case 'h':
         if (ac != 11 && ac != 12)
         {
-            char buf[NC];
-            (void) sprintf (buf,
+            (void) sprintf (why,
                             "Need T,i,O,o,e,q,D,g,k[,siz] for hyperbolic object %s", av[0]);
-            f_msg (buf);
             return (-1);
         }
         obj_dhyperbolic (op, ac, av);
@@ -528,30 +645,25 @@ char *s;
     case 'p':
         if (ac != 10 && ac != 11)
         {
-            char buf[NC];
-            (void) sprintf (buf,
+            (void) sprintf (why,
                             "Need T,i,o,q,O,D,g,k[,siz] for parabolic object %s", av[0]);
-            f_msg (buf);
             return (-1);
         }
         obj_dparabolic (op, ac, av);
         break;
 
     default:
-    {
-        char buf[NC];
-        (void) sprintf (buf, "Unknown type for Object %s: %s",
+        (void) sprintf (why, "Unknown type for Object %s: %.20s",
                         av[0], av[1]);
-        f_msg (buf);
         return (-1);
     }
-    }
 
     return (0);
 }
 
 /* if name, then look it up in the ephem database file and set p.
- * else display a table of all objects and let op pick one.
+ * else display a table of all objects and let op pick one, perhaps after
+ * narrowing it down by typing part of the name.
  * p is either OBJX or OBJY.
  * if -d was used use it; else if EPHEMDB env set use it, else use default.
  * return 0 if successfully set object p, else -1.
@@ -570,21 +682,29 @@ char *name;
 #define	RCTN(r,c)	((r)*NLC+(c))	/* row/col to index */
 #define	NTR(n)		((n)/NLC)	/* index to row */
 #define	NTC(n)		((n)%NLC)	/* index to col (0 based) */
+#define	VTD(k)		(v ? v[k] : (k)) /* view index to db_recs index */
     /* N.B. all these are 0-based */
     static char prompt[] =
-        "RETURN to select, p/n for previous/next page, q to quit";
-    FILE *fp;
+        "RETURN selects, p/n for prev/next page, / to find, q to quit";
+    static char fprompt[] =	/* shorter, to leave room for the pattern */
+        "RETURN selects, / to find, q to quit";
+    Obj *op = (p == OBJX) ? &objx : &objy;
     char *fn;
     int i, pgn;	/* index on current screen, current page number */
-    int r, c;
-    char buf[160];	/* longer than any one database line */
-    char pb[NC];	/* prompt buffer */
-    int readahd;	/* 1 if buffer set from previous loop */
+    int r, c, ch;
+    char buf[NC];
+    char pb[2*NC];	/* prompt buffer; in practice it fits in NC */
+    int last;	/* 1 if current page is the last */
     int choice;	/* index to selection; -1 until set */
     int roaming;	/* 1 while just roaming around screen */
     int abandon;	/* 1 if decide to not pick afterall */
+    char pat[MAXNM];	/* what op has typed to find */
+    int npat;		/* its length */
+    int finding;	/* 1 while op is typing pat */
+    int *v;		/* db_recs indices now shown, or 0 for all of them */
+    int nv;		/* number of them */
 
-    /* open the database file */
+    /* load the database file */
     if (dbfile)
         fn = dbfile;
     else
@@ -593,37 +713,55 @@ char *name;
         if (!fn)
             fn = dbfdef;
     }
-    fp = fopen (fn, "r");
-    if (!fp)
+    if (db_load (fn, buf) < 0)
     {
-        (void) sprintf (buf, "Can not open database file %s", fn);
         f_msg(buf);
         return(-1);
     }
 
-    /* name is specified so just search for it without any op interaction */
+    /* name is specified so just search for it without any op interaction.
+     * it may be just the start of a name; an exact match is preferred, else
+     * the first in the file.
+     */
     if (name)
     {
         int nl = strlen (name);
-        int ret = 0;
-        while (nxt_db(buf, sizeof(buf), fp) == 0 && strncmp(buf, name, nl))
-            continue;
-        if (feof(fp))
+        int n, lo, j;
+
+        if (nl > MAXNM-1)
+            nl = MAXNM-1;
+        n = db_prefix (name, &lo);
+        for (i = lo, j = -1; i < lo + n; i++)
         {
-            (void) sprintf (buf, "Object %s not found", name);
+            char *np = db_name (&db_recs[db_idx[i]]);
+
+            if (strncmp (np, name, nl) != 0)
+                continue;
+            if (np[nl] == '\0')
+            {
+                j = db_idx[i];
+                break;
+            }
+            if (j < 0 || db_idx[i] < j)
+                j = db_idx[i];
+        }
+        if (j < 0)
+        {
+            (void) sprintf (buf, "Object %.40s not found", name);
             f_msg (buf);
-            ret = -1;
+            return (-1);
         }
-        else
-            (void) obj_define (p, buf);
-        (void) fclose (fp);
-        return (ret);
+        db_use (op, &db_recs[j]);
+        return (0);
     }
 
     pgn = 0;
-    readahd = 0;
     choice = -1;
     abandon = 0;
+    npat = 0;
+    pat[0] = '\0';
+    finding = 0;
+    nv = db_match (pat, &v);
 
     /* continue until a choice is made or op abandons the attempt */
     do
@@ -632,42 +770,73 @@ char *name;
          * leave top row open for messages.
          */
         c_erase();
-        for (i = 0; i < NL; )
-            if (readahd || nxt_db (buf, sizeof(buf), fp) == 0)
-            {
-                char objname[LCW];
-                int ii;
-                for (ii = 0; ii < sizeof(objname)-1; ii++)
-                    if ((objname[ii] = buf[ii]) == ',')
-                        break;
-                objname[ii] = '\0';
-                if (i == NL-1)
-                    objname[LCW-2] = '\0'; /* avoid scroll in low-r corner*/
-                f_string (NTR(i)+2, NTC(i)*LCW+1, objname);
-                i++;
-                readahd = 0;
-            }
-            else
-                break;
-
-        /* read another to check for eof. if valid, set readahd for next
-         * time.
-         */
-        if (nxt_db (buf, sizeof(buf), fp) == 0)
-            readahd = 1;
+        for (i = 0; i < NL && NL*pgn + i < nv; i++)
+        {
+            char objname[LCW];
+            (void) sprintf (objname, "%.*s", LCW-1,
+                            db_name (&db_recs[VTD(NL*pgn + i)]));
+            if (i == NL-1)
+                objname[LCW-2] = '\0'; /* avoid scroll in low-r corner*/
+            f_string (NTR(i)+2, NTC(i)*LCW+1, objname);
+        }
+        last = NL*(pgn+1) >= nv;
 
         /* let op pick one. set cursor on first one.
-         * remember these r/c are 0-based, but c_pos() is 1-based
+         * remember these r/c are 0-based, but c_pos() is 1-based.
+         * while finding, leave the cursor after what op has typed.
          */
-        (void) sprintf (pb, "Page %d%s. %s", pgn+1,
-                        feof(fp) ? " (last)" : "", prompt);
+        if (finding)
+            (void) sprintf (pb, "%d found. RETURN when done. Find: %s",
+                            nv, pat);
+        else if (npat > 0)
+            (void) sprintf (pb, "Page %d%s of \"%s\". %s", pgn+1,
+                            last ? " (last)" : "", pat, fprompt);
+        else
+            (void) sprintf (pb, "Page %d%s. %s", pgn+1,
+                            last ? " (last)" : "", prompt);
         f_prompt(pb);
         r = c = 0;
         roaming = 1;
         do
         {
+            if (finding)
+            {
+                switch (ch = read_char())
+                {
+                case cntrl('h'):
+                case 0177:
+                    if (npat > 0)
+                        pat[--npat] = '\0';
+                    break;
+                case cntrl('u'):
+                    pat[npat = 0] = '\0';
+                    break;
+                case '\r':
+                    finding = 0;
+                    break;
+                case REDRAW:
+                    break;
+                default:
+                    if (npat < MAXNM-1 && isprint(ch))
+                    {
+                        pat[npat++] = ch;
+                        pat[npat] = '\0';
+                    }
+                    else
+                        continue;
+                    break;
+                }
+                nv = db_match (pat, &v);
+                pgn = 0;
+                roaming = 0;
+                continue;
+            }
+
             c_pos (r+2, c*LCW+1);
-            switch (read_char())
+            ch = read_char();
+            if (i == 0 && (ch == 'h' || ch == 'j' || ch == 'k' || ch == 'l'))
+                continue;	/* nothing to move over */
+            switch (ch)
             {
             case 'h': /* left */
                 if (c == 0) c = NLC;
@@ -692,43 +861,39 @@ char *name;
                     c = 0;
                 break;
             case REDRAW:
-                /* start over and skip over prior pages' entries */
-                rewind(fp);
-                for (i = 0; i < NL*pgn; i++)
-                    (void) nxt_db (buf, sizeof(buf), fp);
-                readahd = 0;
                 roaming = 0;
                 break;
             case 'p':
-                /* if not at first page, start over and skip back one
-                 * pages' entries
-                 */
+                /* if not at first page, back up one */
                 if (pgn > 0)
                 {
-                    rewind(fp);
                     pgn--;
-                    for (i = 0; i < NL*pgn; i++)
-                        (void) nxt_db (buf, sizeof(buf), fp);
-                    readahd = 0;
                     roaming = 0;
                 }
                 break;
             case 'n':
-                /* if not already at eof, we can go ahead another page */
-                if (!feof (fp))
+                /* if not already on the last page, go ahead one */
+                if (!last)
                 {
                     pgn++;
                     roaming = 0;
                 }
                 break;
+            case '/':
+                finding = 1;
+                roaming = 0;
+                break;
             case END:
                 abandon = 1;
                 roaming = 0;
                 break;
             case ' ':
             case '\r':
-                choice = NL*pgn + RCTN(r,c);
-                roaming = 0;
+                if (i > 0)
+                {
+                    choice = VTD(NL*pgn + RCTN(r,c));
+                    roaming = 0;
+                }
                 break;
             }
         }
@@ -737,37 +902,604 @@ char *name;
     while (choice < 0 && !abandon);
 
     if (choice >= 0)
-    {
-        /* skip first choice entries; selection is the next one */
-        (void) rewind (fp);
-        for (i = 0; i < choice; i++)
-            (void) nxt_db (buf, sizeof(buf), fp);
-        (void) nxt_db (buf, sizeof(buf), fp);
-        (void) obj_define (p, buf);
-    }
-    (void) fclose (fp);
+        db_use (op, &db_recs[choice]);
     redraw_screen (2);
     return (choice >= 0 ? 0 : -1);
 }
 
-/* read database file fp and put next valid entry into buf.
- * return 0 if ok, else -1
+/* set fm to take equatorial unit vectors at epoch ep to the ecliptic of jd,
+ * unless it already does.
  */
-static
-int nxt_db (buf, blen, fp)
-char buf[];
-int blen;
-FILE *fp;
+static void
+fixed_matrix (ep, jd)
+double ep, jd;
 {
-    char s;
-    while (1)
+    double p[3][3], e[3][3];
+    int i, j;
+
+    if (ep == fm_ep && jd == fm_jd)
+        return;
+
+    eq_ecl_matrix (jd, e);
+    if (ep == jd)
+        (void) memcpy ((char *)fm, (char *)e, sizeof(fm));
+    else
     {
-        if (fgets (buf, blen, fp) == 0)
+        precess_matrix (ep, jd, p);
+        for (i = 0; i < 3; i++)
+            for (j = 0; j < 3; j++)
+                fm[i][j] = e[i][0]*p[0][j] + e[i][1]*p[1][j]
+                           + e[i][2]*p[2][j];
+    }
+    fm_ep = ep;
+    fm_jd = jd;
+}
+
+/* make sure the database file fn is loaded into db_recs[].
+ * return 0 if ok, else put the reason in why[] and return -1.
+ */
+static int
+db_load (fn, why)
+char *fn;
+char why[];
+{
+    struct stat st;
+
+    if (stat (fn, &st) < 0)
+    {
+        (void) sprintf (why, "Can not open database file %.40s", fn);
+        return (-1);
+    }
+    if (db_fn && strcmp (db_fn, fn) == 0 && db_mtime == (double)st.st_mtime
+            && db_size == (double)st.st_size)
+        return (0);
+
+    db_free();
+    if (db_mapsaved (fn, &st) < 0)
+    {
+        if (db_crackall (fn, why) < 0)
             return (-1);
-        s = buf[0];
-        if (isalpha(s))
+        db_mtime = (double)st.st_mtime;
+        db_size = (double)st.st_size;
+        db_save (fn);
+    }
+    db_mtime = (double)st.st_mtime;
+    db_size = (double)st.st_size;
+    db_fn = malloc (strlen(fn)+1);
+    if (db_fn)
+        (void) strcpy (db_fn, fn);
+    return (0);
+}
+
+/* forget any database now loaded */
+static void
+db_free ()
+{
+    if (db_map)
+        (void) munmap (db_map, db_maplen);
+    if (db_fn)
+        free (db_fn);
+    db_map = 0;
+    db_maplen = 0;
+    db_fn = 0;
+    db_recs = 0;
+    db_nrec = 0;
+    db_idx = 0;
+    db_nsub = -1;
+}
+
+/* map in the DbRecs saved from database file fn, if they are still good.
+ * return 0 if ok, else -1.
+ */
+static int
+db_mapsaved (fn, sp)
+char *fn;
+struct stat *sp;	/* stat of fn */
+{
+    char *bfn = malloc (strlen(fn) + sizeof(DB_SUFFIX));
+    struct stat bst;
+    DbHdr h;
+    size_t len;
+    char *map;
+    int fd;
+
+    if (!bfn)
+        return (-1);
+    (void) sprintf (bfn, "%s%s", fn, DB_SUFFIX);
+    fd = open (bfn, O_RDONLY);
+    free (bfn);
+    if (fd < 0)
+        return (-1);
+    if (fstat (fd, &bst) < 0 || read (fd, (char *)&h, sizeof(h)) != sizeof(h)
+            || memcmp (h.h_magic, DB_MAGIC, sizeof(h.h_magic)) != 0
+            || h.h_recsize != sizeof(DbRec) || h.h_nrec < 0
+            || h.h_mtime != (double)sp->st_mtime
+            || h.h_size != (double)sp->st_size
+            || bst.st_size != sizeof(h)
+                              + (off_t)h.h_nrec*(sizeof(DbRec)+sizeof(int)))
+    {
+        (void) close (fd);
+        return (-1);
+    }
+    len = bst.st_size;
+    map = mmap ((void *)0, len, PROT_READ, MAP_PRIVATE, fd, (off_t)0);
+    (void) close (fd);
+    if (map == MAP_FAILED)
+        return (-1);
+
+    db_map = map;
+    db_maplen = len;
+    db_recs = (DbRec *)(map + sizeof(h));
+    db_nrec = h.h_nrec;
+    db_idx = (int *)(db_recs + db_nrec);
+    return (0);
+}
+
+/* crack every object line in database file fn into db_recs[].
+ * lines are shared out among child processes, one per processor, each
+ * writing its DbRecs straight into a shared map.
+ * return 0 if ok, else put the reason in why[] and return -1.
+ */
+static int
+db_crackall (fn, why)
+char *fn;
+char why[];
+{
+    pid_t pids[DB_MAXPROCS];
+    FILE *fp;
+    char *text;
+    long *lines;
+    long sz, i;
+    int n, nw, w, j, r;
+    size_t len;
+    char *map;
+    long ncpu;
+
+    /* read the whole file and find the start of each object line */
+    fp = fopen (fn, "r");
+    if (!fp)
+    {
+        (void) sprintf (why, "Can not open database file %.40s", fn);
+        return (-1);
+    }
+    (void) fseek (fp, 0L, SEEK_END);
+    sz = ftell (fp);
+    rewind (fp);
+    text = malloc (sz + 1);
+    lines = malloc ((sz/2 + 1)*sizeof(long));	/* a line is at least 2 */
+    if (!text || !lines || fread (text, 1, sz, fp) != sz)
+    {
+        (void) sprintf (why, "Can not read database file %.40s", fn);
+        (void) fclose (fp);
+        if (text)
+            free (text);
+        if (lines)
+            free ((char *)lines);
+        return (-1);
+    }
+    (void) fclose (fp);
+    text[sz] = '\0';
+    for (i = 0, n = 0; i < sz; )
+    {
+        long e;
+
+        for (e = i; e < sz && text[e] != '\n'; e++)
+            continue;
+        text[e] = '\0';
+        if (e - i >= DB_MAXLINE)
+            text[i + DB_MAXLINE-1] = '\0';
+        if (isalpha(text[i]))
+            lines[n++] = i;
+        i = e + 1;
+    }
+
+    /* one map for all the records, shared with the children if we can,
+     * with room after them for db_idx[].
+     */
+    len = (n > 0 ? n : 1)*(sizeof(DbRec) + sizeof(int));
+    map = mmap ((void *)0, len, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANON,
+                -1, (off_t)0);
+    if (map == MAP_FAILED)
+    {
+        (void) sprintf (why, "No memory for %d objects", n);
+        free (text);
+        free ((char *)lines);
+        return (-1);
+    }
+    db_map = map;
+    db_maplen = len;
+    db_recs = (DbRec *)map;
+
+    ncpu = sysconf (_SC_NPROCESSORS_ONLN);
+    nw = ncpu > 1 ? (int)ncpu : 1;
+    if (nw > DB_MAXPROCS)
+        nw = DB_MAXPROCS;
+    if (nw > n/DB_MINLINES)
+        nw = n/DB_MINLINES > 1 ? n/DB_MINLINES : 1;
+    (void) fflush (stdout);
+    for (w = 1; w < nw; w++)
+    {
+        pids[w] = fork();
+        if (pids[w] == 0)
+        {
+            db_crackshare (text, lines, w, nw, n);
+            _exit (0);
+        }
+    }
+    db_crackshare (text, lines, 0, nw, n);
+    r = 0;
+    for (w = 1; w < nw; w++)
+    {
+        int status;
+
+        if (pids[w] < 0)
+            db_crackshare (text, lines, w, nw, n);
+        else if (waitpid (pids[w], &status, 0) != pids[w]
+                 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            r = -1;
+    }
+    free (text);
+    free ((char *)lines);
+    if (r < 0)
+    {
+        (void) sprintf (why, "A process reading %.40s failed", fn);
+        db_free();
+        return (-1);
+    }
+
+    /* squeeze out the bad lines */
+    for (i = 0, j = 0; i < n; i++)
+        if (db_recs[i].d_type)
+        {
+            if (j != i)
+                db_recs[j] = db_recs[i];
+            j++;
+        }
+    db_nrec = j;
+
+    if (db_sort() < 0)
+    {
+        (void) sprintf (why, "No memory to sort %d objects", db_nrec);
+        db_free();
+        return (-1);
+    }
+    return (0);
+}
+
+/* crack share w of nw of the n lines of text into db_recs[] */
+static void
+db_crackshare (text, lines, w, nw, n)
+char *text;
+long *lines;
+int w, nw, n;
+{
+    int i0 = (int)((long)n*w/nw), i1 = (int)((long)n*(w+1)/nw);
+    char why[NC];
+    int i;
+
+    for (i = i0; i < i1; i++)
+    {
+        DbRec *dp = &db_recs[i];
+        Obj o;
+
+        (void) memset ((char *)&o, 0, sizeof(o));
+        (void) memset ((char *)dp, 0, sizeof(*dp));
+        if (obj_crack (&o, text + lines[i], why) < 0)
+            continue;
+        switch (o.o_type)
+        {
+        case FIXED:
+            dp->d_u.d_f = o.o_f;
+            break;
+        case ELLIPTICAL:
+            dp->d_u.d_e = o.o_e;
+            break;
+        case HYPERBOLIC:
+            dp->d_u.d_h = o.o_h;
+            break;
+        case PARABOLIC:
+            dp->d_u.d_p = o.o_p;
+            break;
+        }
+        dp->d_type = o.o_type;
+    }
+}
+
+/* save db_recs[] for database file fn, with a name made by adding DB_SUFFIX.
+ * write a temporary and rename it, so a reader never sees part of one.
+ * if it can't be saved we just crack the file again next time.
+ */
+static void
+db_save (fn)
+char *fn;
+{
+    char *bfn = malloc (strlen(fn) + sizeof(DB_SUFFIX));
+    char *tfn = malloc (strlen(fn) + sizeof(DB_SUFFIX) + 20);
+    DbHdr h;
+    FILE *fp;
+    int ok;
+
+    if (!bfn || !tfn)
+        goto out;
+    (void) sprintf (bfn, "%s%s", fn, DB_SUFFIX);
+    (void) sprintf (tfn, "%s.%ld", bfn, (long)getpid());
+    fp = fopen (tfn, "w");
+    if (!fp)
+        goto out;
+
+    (void) memset ((char *)&h, 0, sizeof(h));
+    (void) memcpy (h.h_magic, DB_MAGIC, sizeof(h.h_magic));
+    h.h_mtime = db_mtime;
+    h.h_size = db_size;
+    h.h_nrec = db_nrec;
+    h.h_recsize = sizeof(DbRec);
+    ok = fwrite ((char *)&h, sizeof(h), 1, fp) == 1
+         && (db_nrec == 0
+             || (fwrite ((char *)db_recs, sizeof(DbRec), db_nrec, fp) == db_nrec
+                 && fwrite ((char *)db_idx, sizeof(int), db_nrec, fp) == db_nrec));
+    if (fclose (fp) != 0)
+        ok = 0;
+    if (!ok || rename (tfn, bfn) < 0)
+        (void) unlink (tfn);
+
+out:
+    if (bfn)
+        free (bfn);
+    if (tfn)
+        free (tfn);
+}
+
+/* return the name of database object *dp */
+static char *
+db_name (dp)
+DbRec *dp;
+{
+    switch (dp->d_type)
+    {
+    case FIXED:
+        return (dp->d_u.d_f.f_name);
+    case ELLIPTICAL:
+        return (dp->d_u.d_e.e_name);
+    case HYPERBOLIC:
+        return (dp->d_u.d_h.h_name);
+    default:
+        return (dp->d_u.d_p.p_name);
+    }
+}
+
+/* a name folded to lower case and the db_recs[] index it is from, to sort */
+#define	DB_FOLD(c)	(isupper(c) ? tolower(c) : (c))
+typedef struct
+{
+    char k_name[MAXNM];
+    int k_i;
+} DbKey;
+
+/* fill db_idx[], just after db_recs[], with the index of each record in order
+ * of name, ignoring case, and in file order among equal names.
+ * return 0 if ok, -1 if no memory.
+ */
+static int
+db_sort ()
+{
+    DbKey *keys;
+    int i, j;
+
+    db_idx = (int *)(db_recs + db_nrec);
+    if (db_nrec == 0)
+        return (0);
+    keys = (DbKey *) malloc (db_nrec*sizeof(DbKey));
+    if (!keys)
+        return (-1);
+    for (i = 0; i < db_nrec; i++)
+    {
+        unsigned char *np = (unsigned char *) db_name (&db_recs[i]);
+
+        for (j = 0; j < MAXNM-1 && np[j]; j++)
+            keys[i].k_name[j] = DB_FOLD(np[j]);
+        keys[i].k_name[j] = '\0';
+        keys[i].k_i = i;
+    }
+    qsort ((void *)keys, db_nrec, sizeof(DbKey), db_keycmp);
+    for (i = 0; i < db_nrec; i++)
+        db_idx[i] = keys[i].k_i;
+    free ((char *)keys);
+    return (0);
+}
+
+/* qsort compare: by folded name, then by index */
+static int
+db_keycmp (p1, p2)
+const void *p1, *p2;
+{
+    const DbKey *k1 = (const DbKey *)p1, *k2 = (const DbKey *)p2;
+    int d = strcmp (k1->k_name, k2->k_name);
+
+    if (d)
+        return (d);
+    return (k1->k_i - k2->k_i);
+}
+
+/* like strncmp() but ignoring case, and in the same order as db_keycmp() */
+static int
+db_foldcmp (s1, s2, n)
+char *s1, *s2;
+int n;
+{
+    unsigned char *u1 = (unsigned char *)s1, *u2 = (unsigned char *)s2;
+
+    for (; n > 0; n--, u1++, u2++)
+    {
+        int c1 = DB_FOLD(*u1), c2 = DB_FOLD(*u2);
+
+        if (c1 != c2)
+            return (c1 - c2);
+        if (c1 == '\0')
+            break;
+    }
+    return (0);
+}
+
+/* find the run of db_idx[] whose names start with pat, ignoring case.
+ * set *lop to where it starts and return its length.
+ */
+static int
+db_prefix (pat, lop)
+char *pat;
+int *lop;
+{
+    int n = strlen (pat);
+    int lo, hi, mid, first;
+
+    if (n > MAXNM-1)
+        n = MAXNM-1;
+    for (lo = 0, hi = db_nrec; lo < hi; )
+    {
+        mid = (lo + hi)/2;
+        if (db_foldcmp (db_name (&db_recs[db_idx[mid]]), pat, n) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    first = lo;
+    for (hi = db_nrec; lo < hi; )
+    {
+        mid = (lo + hi)/2;
+        if (db_foldcmp (db_name (&db_recs[db_idx[mid]]), pat, n) == 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    *lop = first;
+    return (lo - first);
+}
+
+/* set *vp to the db_recs[] indices of the objects whose names match pat and
+ * return how many there are. those that start with pat, ignoring case, are
+ * found in db_idx[]; if there are none we settle for those that contain it
+ * anywhere, in order of name. when pat just adds to the last pat that got
+ * that far, only the names that matched it need be looked at again.
+ * an empty pat matches all, in file order, with *vp set to 0.
+ */
+static int
+db_match (pat, vp)
+char *pat;
+int **vp;
+{
+    int n = strlen (pat);
+    int *from;	/* the indices to look through, then ... */
+    int nk;	/* ... how many */
+    int lo, m, j, k, c0;
+
+    if (n == 0)
+    {
+        *vp = 0;
+        return (db_nrec);
+    }
+    if (n > MAXNM-1)
+        n = MAXNM-1;
+    m = db_prefix (pat, &lo);
+    if (m > 0)
+    {
+        *vp = db_idx + lo;
+        return (m);
+    }
+
+    if (db_subroom < db_nrec)
+    {
+        int *sp = (int *) realloc ((char *)db_sub, db_nrec*sizeof(int));
+        if (!sp)
+        {
+            *vp = 0;
             return (0);
+        }
+        db_sub = sp;
+        db_subroom = db_nrec;
+        db_nsub = -1;
+    }
+    if (db_nsub >= 0 && strncmp (pat, db_subpat, strlen(db_subpat)) == 0)
+    {
+        from = db_sub;		/* m never passes k, so this is safe */
+        nk = db_nsub;
+    }
+    else
+    {
+        from = db_idx;
+        nk = db_nrec;
+    }
+    c0 = DB_FOLD((unsigned char)pat[0]);
+    for (k = 0, m = 0; k < nk; k++)
+    {
+        int di = from[k];
+        unsigned char *np = (unsigned char *) db_name (&db_recs[di]);
+
+        for (j = 0; np[j]; j++)
+            if (DB_FOLD(np[j]) == c0 && db_foldcmp ((char *)np+j, pat, n) == 0)
+            {
+                db_sub[m++] = di;
+                break;
+            }
+    }
+    (void) sprintf (db_subpat, "%.*s", n, pat);
+    db_nsub = m;
+    *vp = db_sub;
+    return (m);
+}
+
+/* make database object *dp the current one of *op */
+static void
+db_use (op, dp)
+Obj *op;
+DbRec *dp;
+{
+    switch (dp->d_type)
+    {
+    case FIXED:
+        op->o_f = dp->d_u.d_f;
+        break;
+    case ELLIPTICAL:
+        op->o_e = dp->d_u.d_e;
+        break;
+    case HYPERBOLIC:
+        op->o_h = dp->d_u.d_h;
+        break;
+    case PARABOLIC:
+        op->o_p = dp->d_u.d_p;
+        break;
+    }
+    op->o_type = dp->d_type;
+}
+
+/* return op's orbital elements reduced from epoch to the RED_TOL grid date
+ * nearest jd, calling reduce_elements() only if that date or the elements
+ * differ from last time. keying on the grid date, not the date of the last
+ * reduction, keeps the answer for jd the same whatever was asked before.
+ */
+static RedElts *
+obj_reduce (op, ep, inc, om, Om, jd)
+Obj *op;
+double ep;		/* equinox of the elements, as an mjd */
+double inc, om, Om;	/* inclination, arg of perihelion and node, degrees */
+double jd;		/* date wanted */
+{
+    RedElts *re = &op->o_red;
+    double g = floor (jd/RED_TOL + 0.5) * RED_TOL;
+
+    if (!re->r_ok || g != re->r_mjd || ep != re->r_epoch
+            || inc != re->r_inc0 || om != re->r_om0 || Om != re->r_Om0)
+    {
+        reduce_elements (ep, g, degrad(inc), degrad(om), degrad(Om),
+                         &re->r_inc, &re->r_om, &re->r_Om);
+        re->r_sinc = sin(re->r_inc);
+        re->r_cinc = cos(re->r_inc);
+        re->r_epoch = ep;
+        re->r_inc0 = inc;
+        re->r_om0 = om;
+        re->r_Om0 = Om;
+        re->r_mjd = g;
+        re->r_ok = 1;
     }
+    return (re);
 }
 
 /* define a fixed object.
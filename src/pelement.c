@@ -110,6 +110,27 @@ static double elements[8][NPELE] =
     }
 };
 
+/* the last elements found for each planet, with what is needed to step
+ *   them on by forward differences when asked again one step later.
+ */
+#define	PE_NFD		256	/* steps before evaluating exactly again */
+#define	PE_HTOL		1e-8	/* steps this close, in days, are the same */
+
+typedef struct
+{
+    int ok;		/* pp[] is good for mjd */
+    double mjd;		/* instant of pp[] */
+    double h;		/* step that brought us to mjd, in days */
+    int nfd;		/* steps since the last exact evaluation, 0 if none */
+    double d[5][3];	/* 1st..3rd differences of pp[0] and pp[2..5] */
+    double pp[9];
+} PeCache;
+
+static PeCache pecache[8];
+
+static void pe_exact (double t, double ep[], double pp[]);
+static void pe_diffs (double t, double k, double ep[], double d[5][3]);
+
 /* given a modified Julian date, mjd, return the elements for the mean orbit
  *   at that instant of all the major planets, together with their
  *   mean daily motions in longitude, angular diameter and standard visual
@@ -125,25 +146,109 @@ void pelement (mjd, plan)
 double mjd;
 double plan[8][9];
 {
-    register double *ep, *pp;
-    register double t = mjd/36525.;
-    double aa;
-    int planet, i;
+    int planet;
 
     for (planet = 0; planet < 8; planet++)
+        pelement1 (mjd, planet, plan[planet]);
+}
+
+/* as pelement() but for just the one planet, filling pp[0..8] with its row.
+ * each planet remembers its last instant. when called again one step later
+ *   than that with the same step as last time, as in a sweep at a constant
+ *   interval, the cubics are stepped on by adding their differences instead
+ *   of being evaluated afresh; every PE_NFD steps, or whenever the step
+ *   changes, they are evaluated exactly again so no error can build up.
+ */
+void pelement1 (mjd, planet, pp)
+double mjd;
+int planet;
+double pp[9];
+{
+    PeCache *pc = &pecache[planet];
+    double *ep = elements[planet];
+    int i;
+
+    if (!pc->ok || mjd != pc->mjd)
     {
-        ep = elements[planet];
-        pp = plan[planet];
-        aa = ep[1]*t;
-        pp[0] = ep[0] + 360.*(aa-(long)aa) + (ep[3]*t + ep[2])*t*t;
-        range (pp, 360.);
-        pp[1] = (ep[1]*9.856263e-3) + (ep[2] + ep[3])/36525;
-
-        for (i = 4; i < 20; i += 4)
-            pp[i/4+1] = ((ep[i+3]*t + ep[i+2])*t + ep[i+1])*t + ep[i+0];
-
-        pp[6] = ep[20];
-        pp[7] = ep[21];
-        pp[8] = ep[22];
+        if (pc->ok && pc->nfd > 0 && pc->nfd < PE_NFD
+                && fabs (mjd - pc->mjd - pc->h) < PE_HTOL)
+        {
+            /* one more step of the same size */
+            for (i = 0; i < 5; i++)
+            {
+                double *d = pc->d[i];
+                pc->pp[i ? i+1 : 0] += d[0];
+                d[0] += d[1];
+                d[1] += d[2];
+            }
+            range (pc->pp, 360.);
+            pc->nfd++;
+        }
+        else
+        {
+            pe_exact (mjd/36525., ep, pc->pp);
+            if (pc->ok)
+            {
+                pc->h = mjd - pc->mjd;
+                pe_diffs (mjd/36525., pc->h/36525., ep, pc->d);
+                pc->nfd = 1;
+            }
+            else
+                pc->nfd = 0;
+        }
+        pc->mjd = mjd;
+        pc->ok = 1;
+    }
+
+    for (i = 0; i < 9; i++)
+        pp[i] = pc->pp[i];
+}
+
+/* evaluate the elements ep[] at t centuries, into pp[0..8] */
+static void
+pe_exact (t, ep, pp)
+double t;
+double ep[];
+double pp[];
+{
+    double aa;
+    int i;
+
+    aa = ep[1]*t;
+    pp[0] = ep[0] + 360.*(aa-(long)aa) + (ep[3]*t + ep[2])*t*t;
+    range (pp, 360.);
+    pp[1] = (ep[1]*9.856263e-3) + (ep[2] + ep[3])/36525;
+
+    for (i = 4; i < 20; i += 4)
+        pp[i/4+1] = ((ep[i+3]*t + ep[i+2])*t + ep[i+1])*t + ep[i+0];
+
+    pp[6] = ep[20];
+    pp[7] = ep[21];
+    pp[8] = ep[22];
+}
+
+/* find the forward differences at t of each of the five cubics in ep[],
+ *   for a step of k centuries. for a0 + a1*t + a2*t**2 + a3*t**3 these are
+ *   1st: a1*k + a2*(2t+k)*k + a3*(3t*t + 3t*k + k*k)*k
+ *   2nd: 2*a2*k*k + 6*a3*(t+k)*k*k
+ *   3rd: 6*a3*k*k*k
+ * the mean longitude's a1 is in revolutions, so is scaled to degrees.
+ */
+static void
+pe_diffs (t, k, ep, d)
+double t, k;
+double ep[];
+double d[5][3];
+{
+    int i;
+
+    for (i = 0; i < 5; i++)
+    {
+        double *a = &ep[4*i];
+        double a1 = i ? a[1] : 360.*a[1];
+
+        d[i][0] = (a1 + a[2]*(2*t + k) + a[3]*(3*t*t + 3*t*k + k*k))*k;
+        d[i][1] = (2*a[2] + 6*a[3]*(t + k))*k*k;
+        d[i][2] = 6*a[3]*k*k*k;
     }
 }
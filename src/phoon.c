@@ -75,6 +75,38 @@ int c_pos ( int r, int c);
 /* If you change the aspect ratio, the canned backgrounds won't work. */
 #define ASPECTRATIO 0.5
 
+/* Rendered moons are cached, since stepping by hours most come out the
+ * same. A frame depends only on the phase, quantised to PF_NQ steps per
+ * lunation, the number of lines, the atfiller and which background art.
+ */
+#define PF_NQ 512		/* phase steps per lunation */
+#define PF_NCACHE 8		/* frames kept, least recently used goes */
+#define PF_MAXLINES 32		/* tallest background */
+#define PF_MAXCOLS 72		/* widest slice, plus room */
+#define PF_ATLEN 32		/* longest atfiller we cache */
+
+typedef struct {
+    int pf_qphase;		/* phase * PF_NQ, or -1 if slot unused */
+    int pf_numlines;
+    int pf_variant;		/* 0 usual art, 1 pumpkin, 2 hubert */
+    char pf_atfiller[PF_ATLEN];
+    unsigned long pf_lastuse;	/* pf_clock when last used */
+    unsigned long pf_gen;	/* changes each time slot is rendered */
+    int pf_pre[PF_MAXLINES];	/* blanks before lit part of each line */
+    int pf_lit[PF_MAXLINES];	/* chars in lit part of each line */
+    int pf_len[PF_MAXLINES];	/* total chars in each line */
+    char pf_text[PF_MAXLINES][PF_MAXCOLS];
+} PhoonFrame;
+
+static PhoonFrame pf_cache[PF_NCACHE];
+static unsigned long pf_clock;	/* counts lookups, for LRU */
+static unsigned long pf_ngen;	/* counts renders, for pf_gen */
+static unsigned long pf_shown;	/* pf_gen of frame now on screen, 0 if none */
+static int pf_shownrow, pf_showncol;	/* where it is */
+
+static PhoonFrame *pf_find( int qphase, int numlines, int variant,
+                            char *atfiller );
+
 
 static void
 putseconds( long secs )
@@ -132,6 +164,52 @@ find_nearest_phoon_size( int nlines, int *pos_dif )
 }
 
 
+/* forget what moon is on the screen, such as after it has been erased,
+ * so the next putmoon_jd() draws it all.
+ */
+void
+putmoon_forget( void )
+{
+    pf_shown = 0;
+}
+
+/* return the cache slot for the given frame. if it is not there the least
+ * recently used slot is given over to it, with pf_gen 0 so the caller knows
+ * it must render it.
+ */
+static PhoonFrame *
+pf_find( int qphase, int numlines, int variant, char *atfiller )
+{
+    PhoonFrame *fp, *oldfp = &pf_cache[0];
+    int cacheable = strlen( atfiller ) < PF_ATLEN;
+
+    if ( pf_clock++ == 0 )
+        for ( fp = pf_cache; fp < &pf_cache[PF_NCACHE]; fp++ )
+            fp->pf_qphase = -1;
+
+    for ( fp = pf_cache; fp < &pf_cache[PF_NCACHE]; fp++ )
+    {
+        if ( cacheable && fp->pf_qphase == qphase
+                && fp->pf_numlines == numlines && fp->pf_variant == variant
+                && strcmp( fp->pf_atfiller, atfiller ) == 0 )
+        {
+            fp->pf_lastuse = pf_clock;
+            return fp;
+        }
+        if ( fp->pf_lastuse < oldfp->pf_lastuse )
+            oldfp = fp;
+    }
+
+    oldfp->pf_qphase = cacheable ? qphase : -1;
+    oldfp->pf_numlines = numlines;
+    oldfp->pf_variant = variant;
+    if ( cacheable )
+        strcpy( oldfp->pf_atfiller, atfiller );
+    oldfp->pf_lastuse = pf_clock;
+    oldfp->pf_gen = 0;		/* not rendered yet */
+    return oldfp;
+}
+
 void
 putmoon_jd( double jd, int numlines, char* atfiller )
 {
@@ -428,6 +506,8 @@ putmoon_jd( double jd, int numlines, char* atfiller )
     int atflrlen, atflridx, numcols, lin, col, midlin;
     double mcap, yrad, xrad, y, xright, xleft;
     int colright, colleft;
+    int qphase, variant;
+    PhoonFrame *fp;
     char c;
 
     /* Find the length of the atfiller string. */
@@ -436,7 +516,8 @@ putmoon_jd( double jd, int numlines, char* atfiller )
     /* Figure out the phase. */
 
     pctphase = phase( jd, &cphase, &aom, &cdist, &cangdia, &csund, &csuang );
-    angphase = pctphase * 2.0 * PI;
+    qphase = (int) ( pctphase * PF_NQ + 0.5 ) % PF_NQ;
+    angphase = (double) qphase / PF_NQ * 2.0 * PI;
     mcap = -cos( angphase );
 
     /* Get now for use as a random number. */
@@ -463,14 +544,33 @@ putmoon_jd( double jd, int numlines, char* atfiller )
     midlin = numlines / 2;
     phasehunt2( jd, phases, which );
 
-    /* Now output the moon, a slice at a time. */
+    /* Pick the background art */
+    variant = 0;
+#ifdef PUMPKIN
+    if ( numlines == 19 )
+    {
+        time_t t;
+        struct tm *tmP;
+        t = julian_to_unix( jd );
+        tmP = localtime( &t );
+        if ( tmP->tm_mon == 9 && clocknow % ( 33 - tmP->tm_mday ) == 1 )
+            variant = 1;
+    }
+#endif
+#ifdef HUBERT
+    if ( numlines == 29 && clocknow % 23 == 3 && cphase > 0.8 )
+        variant = 2;
+#endif
+
+    /* Render the moon into a frame, a slice at a time, unless the same one
+     * is still in the cache.
+     */
+    fp = pf_find( qphase, numlines, variant, atfiller );
     atflridx = 0;
-    for ( lin = 0; lin < numlines; lin = lin + 1 )
+    for ( lin = 0; fp->pf_gen == 0 && lin < numlines; lin = lin + 1 )
     {
-        c_pos( 2    // ephem watch header (2 lines)
-               + top_marg      // to vertically center phoon
-               + lin,  // current phoon slice line
-               leftmarg ); // to horizontally center phoon + info text
+        char *tp = fp->pf_text[lin];
+        char *endp = &fp->pf_text[lin][PF_MAXCOLS];
 
         /* Compute the edges of this slice. */
         y = lin + 0.5 - yrad;
@@ -483,11 +583,11 @@ putmoon_jd( double jd, int numlines, char* atfiller )
         colleft = (int) (xrad + 0.5) + (int) (xleft + 0.5);
         colright = (int) (xrad + 0.5) + (int) (xright + 0.5);
 
-        /* Now output the slice. */
-        for ( col = 0; col < colleft; ++col )
-            putchar( ' ' );
-        COLOR_CODE(COLOR_PHOON);
-        for ( ; col <= colright; ++col )
+        /* Now render the slice. */
+        for ( col = 0; col < colleft && tp < endp; ++col )
+            *tp++ = ' ';
+        fp->pf_pre[lin] = tp - fp->pf_text[lin];
+        for ( ; col <= colright && tp < endp; ++col )
         {
             switch ( numlines )
             {
@@ -495,19 +595,13 @@ putmoon_jd( double jd, int numlines, char* atfiller )
                 c = background18[lin][col];
                 break;
             case 19:
-            {
 #ifdef PUMPKIN
-                time_t t;
-                t = julian_to_unix( jd );
-                tmP = localtime( &t );
-                if ( tmP->tm_mon == 9 &&
-                        clocknow % ( 33 - tmP->tm_mday ) == 1 )
+                if ( variant == 1 )
                     c = pumpkin19[lin][col];
                 else
 #endif
                     c = background19[lin][col];
-            }
-            break;
+                break;
             case 21:
                 c = background21[lin][col];
                 break;
@@ -522,7 +616,7 @@ putmoon_jd( double jd, int numlines, char* atfiller )
                 break;
             case 29:
 #ifdef HUBERT
-                if ( clocknow % 23 == 3 && cphase > 0.8 && numlines >= 29 )
+                if ( variant == 2 )
                     c = hubert29[lin][col];
                 else
 #endif
@@ -535,21 +629,53 @@ putmoon_jd( double jd, int numlines, char* atfiller )
                 c = '@';
             }
             if ( c != '@' )
-                putchar( c );
+                *tp++ = c;
             else
             {
-                putchar( atfiller[atflridx] );
+                *tp++ = atfiller[atflridx];
                 atflridx = ( atflridx + 1 ) % atflrlen;
             }
         }
-        COLOR_OFF;
-
-        for ( ; col <= numcols; ++col )
-            putchar( ' ' );
-
+        fp->pf_lit[lin] = tp - fp->pf_text[lin] - fp->pf_pre[lin];
 
+        for ( ; col <= numcols && tp < endp; ++col )
+            *tp++ = ' ';
+        fp->pf_len[lin] = tp - fp->pf_text[lin];
+    }
+    if ( fp->pf_gen == 0 )
+        fp->pf_gen = ++pf_ngen;
+
+    /* Now output the moon, a slice at a time, unless it is already showing
+     * right there.
+     */
+    if ( fp->pf_gen != pf_shown || pf_shownrow != top_marg
+            || pf_showncol != leftmarg )
+    {
+        for ( lin = 0; lin < numlines; lin = lin + 1 )
+        {
+            char *tp = fp->pf_text[lin];
+
+            c_pos( 2    // ephem watch header (2 lines)
+                   + top_marg      // to vertically center phoon
+                   + lin,  // current phoon slice line
+                   leftmarg ); // to horizontally center phoon + info text
+            fwrite( tp, 1, fp->pf_pre[lin], stdout );
+            COLOR_CODE(COLOR_PHOON);
+            fwrite( tp + fp->pf_pre[lin], 1, fp->pf_lit[lin], stdout );
+            COLOR_OFF;
+            fwrite( tp + fp->pf_pre[lin] + fp->pf_lit[lin], 1,
+                    fp->pf_len[lin] - fp->pf_pre[lin] - fp->pf_lit[lin],
+                    stdout );
+        }
+        pf_shown = fp->pf_gen;
+        pf_shownrow = top_marg;
+        pf_showncol = leftmarg;
+    }
 
-        /* Output the end-of-line information, if any. */
+    /* Output the end-of-line information, if any. */
+    for ( lin = midlin - 2; lin <= midlin + 1; lin = lin + 1 )
+    {
+        c_pos( 2 + top_marg + lin, leftmarg + fp->pf_len[lin] );
         if ( lin == midlin - 2 )
         {
             fputs( "\t ", stdout );
@@ -33,6 +33,7 @@
 #include <time.h>
 
 #include "phoonastro.h"
+#include "ephem.h"
 
 
 #define FALSE 0
@@ -304,38 +305,43 @@ phasehunt5( double sdate, double phases[5] )
 /*
  * PHASEHUNT2  --  Find time of phases of the moon which surround
  *		the current date.  Two phases are found.
+ *
+ *		The pair found last time is kept and walked a quarter
+ *		at a time with mph_time() while the date moves a little,
+ *		as it does when watching, so most calls cost nothing.
  */
 void
 phasehunt2( double sdate, double phases[2], double which[2] )
 {
-    double phases5[5];
-
-    phasehunt5( sdate, phases5 );
-    phases[0] = phases5[0];
-    which[0] = 0.0;
-    phases[1] = phases5[1];
-    which[1] = 0.25;
-    if ( phases[1] <= sdate )
+    static long q;		/* phase number of t1, as for mph_time() */
+    static double t0, t1;	/* mjd of phases q-1 and q */
+    static int valid;
+    double mjd = sdate - 2415020.0;
+    int steps;
+
+    for ( steps = 0; valid && steps < 8 && mjd >= t1; steps++ )
+    {
+        t0 = t1;
+        t1 = mph_time( ++q );
+    }
+    for ( ; valid && steps < 8 && mjd < t0; steps++ )
     {
-        phases[0] = phases[1];
-        which[0] = which[1];
-        phases[1] = phases5[2];
-        which[1] = 0.5;
-        if ( phases[1] <= sdate )
-        {
-            phases[0] = phases[1];
-            which[0] = which[1];
-            phases[1] = phases5[3];
-            which[1] = 0.75;
-            if ( phases[1] <= sdate )
-            {
-                phases[0] = phases[1];
-                which[0] = which[1];
-                phases[1] = phases5[4];
-                which[1] = 0.0;
-            }
-        }
+        t1 = t0;
+        t0 = mph_time( --q - 1 );
     }
+    if ( !valid || steps == 8 )
+    {
+        q = mph_seed( mjd, &t1 );
+        if ( t1 <= mjd )
+            t1 = mph_time( ++q );
+        t0 = mph_time( q - 1 );
+        valid = TRUE;
+    }
+
+    phases[0] = t0 + 2415020.0;
+    which[0] = ( ( q - 1 ) & 3 ) / 4.0;
+    phases[1] = t1 + 2415020.0;
+    which[1] = ( q & 3 ) / 4.0;
 }
 
 
@@ -6,6 +6,14 @@
 #define	TWOPI		(2*PI)
 #define	mod2PI(x)	((x) - (long)((x)/TWOPI)*TWOPI)
 
+/* sin and cos of a+b and a-b, given those of a and of b */
+#define	SSUM(sa,ca,sb,cb)	((sa)*(cb) + (ca)*(sb))
+#define	CSUM(sa,ca,sb,cb)	((ca)*(cb) - (sa)*(sb))
+#define	SDIFF(sa,ca,sb,cb)	((sa)*(cb) - (ca)*(sb))
+#define	CDIFF(sa,ca,sb,cb)	((ca)*(cb) + (sa)*(sb))
+
+static void aux_jsun (double t, double *x1, double sx[7], double cx[7]);
+static void harmonics (double sx, double cx, int n, double s[], double c[]);
 static void masun (double mjd, double *mas);
 static void p_mercury (double map[], double *dl, double *dr);
 static void p_venus (double t, double mas, double map[], double *dl, double *dr,
@@ -37,8 +45,9 @@ static void p_neptune (double t, double s, double *dl, double *dr, double *dml,
  *   mag:  visual magnitude when 1 AU from sun and earth at 0 phase angle.
  *
  * all angles are in radians, all distances in AU.
- * the mean orbital elements are found by calling pelement(), then mutual
- *   perturbation corrections are applied as necessary.
+ * the mean orbital elements are found by calling pelement1() for just the
+ *   planets whose mean anomalies are needed, then mutual perturbation
+ *   corrections are applied as necessary.
  *
  * corrections for nutation and abberation must be made by the caller. The RA
  *   and DEC calculated from the fully-corrected ecliptic coordinates are then
@@ -53,8 +62,15 @@ double mjd;
 int p;
 double *lpd0, *psi0, *rp0, *rho0, *lam, *bet, *dia, *mag;
 {
-    static double plan[8][9];
-    static double lastmjd = -10000;
+    /* planets whose elements are needed for each planet's perturbations */
+    static int needs[8] =
+    {
+        (1<<MERCURY)|(1<<VENUS)|(1<<JUPITER),
+        (1<<VENUS)|(1<<JUPITER),
+        (1<<VENUS)|(1<<MARS)|(1<<JUPITER),
+        1<<JUPITER, 1<<SATURN, 1<<URANUS, 1<<NEPTUNE, 1<<PLUTO
+    };
+    double plan[8][9];
     double dl;	/* perturbation correction for longitude */
     double dr;	/*  "   orbital radius */
     double dml;	/*  "   mean longitude */
@@ -81,12 +97,12 @@ double *lpd0, *psi0, *rp0, *rho0, *lam, *bet, *dia, *mag;
     double spsi, cpsi;
     double rpd;
 
-    /* only need to fill in plan[] once for a given mjd */
-    if (mjd != lastmjd)
-    {
-        pelement (mjd, plan);
-        lastmjd = mjd;
-    }
+    PROF_IN(PF_PLANS);
+
+    /* only fill in the rows of plan[] we are going to use */
+    for (j = 0; j < 8; j++)
+        if (needs[p] & (1<<j))
+            pelement1 (mjd, j, plan[j]);
 
     dt = 0;
     t = mjd/36525.;
@@ -95,6 +111,15 @@ double *lpd0, *psi0, *rp0, *rho0, *lam, *bet, *dia, *mag;
     re = rsn;
     lg = lsn+PI;
 
+    /* set initial corrections to 0 */
+    dl = 0;
+    dr = 0;
+    dml = 0;
+    ds = 0;
+    dm = 0;
+    da = 0;
+    dhl = 0;
+
     /* first find the true position of the planet at mjd.
      * then repeat a second time for a slightly different time based
      * on the position found in the first pass to account for light-travel
@@ -104,53 +129,50 @@ double *lpd0, *psi0, *rp0, *rho0, *lam, *bet, *dia, *mag;
     {
 
         for (j = 0; j < 8; j++)
-            map[j] = degrad(plan[j][0]-plan[j][2]-dt*plan[j][1]);
+            if (needs[p] & (1<<j))
+                map[j] = degrad(plan[j][0]-plan[j][2]-dt*plan[j][1]);
 
-        /* set initial corrections to 0.
-         * then modify as necessary for the planet of interest.
+        /* modify the corrections as necessary for the planet of interest.
+         * those for jupiter and beyond depend only on t, not on dt, so
+         * they are the same on the second pass and are kept from the first.
          */
-        dl = 0;
-        dr = 0;
-        dml = 0;
-        ds = 0;
-        dm = 0;
-        da = 0;
-        dhl = 0;
-
-        switch (p)
+        if (pass == 0 || p < JUPITER)
         {
+            switch (p)
+            {
 
-        case MERCURY:
-            p_mercury (map, &dl, &dr);
-            break;
+            case MERCURY:
+                p_mercury (map, &dl, &dr);
+                break;
 
-        case VENUS:
-            p_venus (t, mas, map, &dl, &dr, &dml, &dm);
-            break;
+            case VENUS:
+                p_venus (t, mas, map, &dl, &dr, &dml, &dm);
+                break;
 
-        case MARS:
-            p_mars (mas, map, &dl, &dr, &dml, &dm);
-            break;
+            case MARS:
+                p_mars (mas, map, &dl, &dr, &dml, &dm);
+                break;
 
-        case JUPITER:
-            p_jupiter (t, plan[p][3], &dml, &ds, &dm, &da);
-            break;
+            case JUPITER:
+                p_jupiter (t, plan[p][3], &dml, &ds, &dm, &da);
+                break;
 
-        case SATURN:
-            p_saturn (t, plan[p][3], &dml, &ds, &dm, &da, &dhl);
-            break;
+            case SATURN:
+                p_saturn (t, plan[p][3], &dml, &ds, &dm, &da, &dhl);
+                break;
 
-        case URANUS:
-            p_uranus (t, plan[p][3], &dl, &dr, &dml, &ds, &dm, &da, &dhl);
-            break;
+            case URANUS:
+                p_uranus (t, plan[p][3], &dl, &dr, &dml, &ds, &dm, &da, &dhl);
+                break;
 
-        case NEPTUNE:
-            p_neptune (t, plan[p][3], &dl, &dr, &dml, &ds, &dm, &da, &dhl);
-            break;
+            case NEPTUNE:
+                p_neptune (t, plan[p][3], &dl, &dr, &dml, &ds, &dm, &da, &dhl);
+                break;
 
-        case PLUTO:
-            /* no perturbation theory for pluto */
-            break;
+            case PLUTO:
+                /* no perturbation theory for pluto */
+                break;
+            }
         }
 
         s = plan[p][3]+ds;
@@ -206,20 +228,69 @@ double *lpd0, *psi0, *rp0, *rho0, *lam, *bet, *dia, *mag;
     *bet = atan(rpd*spsi*sin(*lam-lpd)/(cpsi*re*sll));
     *dia = plan[p][7];
     *mag = plan[p][8];
+    PROF_OUT(PF_PLANS);
 }
 
-/* set auxilliary variables used for jupiter, saturn, uranus, and neptune */
+/* set auxilliary variables used for jupiter, saturn, uranus, and neptune.
+ * x1 is returned as is. the angles x2..x6 are only ever used inside sin()
+ *   and cos() so instead sx[i] and cx[i] are set to sin(xi) and cos(xi),
+ *   i = 2..6. only x2, x3 and x4 go to the math library; x5 and x6 are sums
+ *   of multiples of those and so are found by angle addition.
+ */
 static
-void aux_jsun (t, x1, x2, x3, x4, x5, x6)
+void aux_jsun (t, x1, sx, cx)
 double t;
-double *x1, *x2, *x3, *x4, *x5, *x6;
+double *x1;
+double sx[7], cx[7];
 {
+    double x2, x3, x4;
+    double s2[3], c2[3], s3[7], c3[7], s4[4], c4[4];
+    double sa, ca;
+
     *x1 = t/5+0.1;
-    *x2 = mod2PI(4.14473+5.29691e1*t);
-    *x3 = mod2PI(4.641118+2.132991e1*t);
-    *x4 = mod2PI(4.250177+7.478172*t);
-    *x5 = 5 * *x3 - 2 * *x2;
-    *x6 = 2 * *x2 - 6 * *x3 + 3 * *x4;
+    x2 = mod2PI(4.14473+5.29691e1*t);
+    x3 = mod2PI(4.641118+2.132991e1*t);
+    x4 = mod2PI(4.250177+7.478172*t);
+    harmonics (sin(x2), cos(x2), 2, s2, c2);
+    harmonics (sin(x3), cos(x3), 6, s3, c3);
+    harmonics (sin(x4), cos(x4), 3, s4, c4);
+    sx[2] = s2[1];
+    cx[2] = c2[1];
+    sx[3] = s3[1];
+    cx[3] = c3[1];
+    sx[4] = s4[1];
+    cx[4] = c4[1];
+
+    /* x5 = 5*x3 - 2*x2 */
+    sx[5] = SDIFF(s3[5], c3[5], s2[2], c2[2]);
+    cx[5] = CDIFF(s3[5], c3[5], s2[2], c2[2]);
+
+    /* x6 = 2*x2 - 6*x3 + 3*x4 */
+    sa = SDIFF(s2[2], c2[2], s3[6], c3[6]);
+    ca = CDIFF(s2[2], c2[2], s3[6], c3[6]);
+    sx[6] = SSUM(sa, ca, s4[3], c4[3]);
+    cx[6] = CSUM(sa, ca, s4[3], c4[3]);
+}
+
+/* given sx = sin(x) and cx = cos(x), set s[k] = sin(k*x) and c[k] = cos(k*x)
+ *   for k = 0..n by the angle-addition recurrences. the harmonics used here
+ *   go no higher than 6 so the rounding error stays down near 1e-15.
+ */
+static
+void harmonics (sx, cx, n, s, c)
+double sx, cx;
+int n;
+double s[], c[];
+{
+    int k;
+
+    s[0] = 0.0;
+    c[0] = 1.0;
+    for (k = 1; k <= n; k++)
+    {
+        s[k] = SSUM(s[k-1], c[k-1], sx, cx);
+        c[k] = CSUM(s[k-1], c[k-1], sx, cx);
+    }
 }
 
 /* find the mean anomaly of the sun at mjd.
@@ -327,31 +398,38 @@ double t, s;
 double *dml, *ds, *dm, *da;
 {
     double dp;
-    double x1, x2, x3, x4, x5, x6, x7;
+    double x1;
+    double sx[7], cx[7];
+    double s3[3], c3[3], s5[3], c5[3], s7[6], c7[6];
     double sx3, cx3, s2x3, c2x3;
     double sx5, cx5, s2x5;
     double sx6;
     double sx7, cx7, s2x7, c2x7, s3x7, c3x7, s4x7, c4x7, c5x7;
 
-    aux_jsun (t, &x1, &x2, &x3, &x4, &x5, &x6);
-    x7 = x3-x2;
-    sx3 = sin(x3);
-    cx3 = cos(x3);
-    s2x3 = sin(2*x3);
-    c2x3 = cos(2*x3);
-    sx5 = sin(x5);
-    cx5 = cos(x5);
-    s2x5 = sin(2*x5);
-    sx6 = sin(x6);
-    sx7 = sin(x7);
-    cx7 = cos(x7);
-    s2x7 = sin(2*x7);
-    c2x7 = cos(2*x7);
-    s3x7 = sin(3*x7);
-    c3x7 = cos(3*x7);
-    s4x7 = sin(4*x7);
-    c4x7 = cos(4*x7);
-    c5x7 = cos(5*x7);
+    aux_jsun (t, &x1, sx, cx);
+
+    /* x7 = x3 - x2 */
+    harmonics (sx[3], cx[3], 2, s3, c3);
+    harmonics (sx[5], cx[5], 2, s5, c5);
+    harmonics (SDIFF(sx[3], cx[3], sx[2], cx[2]),
+               CDIFF(sx[3], cx[3], sx[2], cx[2]), 5, s7, c7);
+    sx3 = s3[1];
+    cx3 = c3[1];
+    s2x3 = s3[2];
+    c2x3 = c3[2];
+    sx5 = s5[1];
+    cx5 = c5[1];
+    s2x5 = s5[2];
+    sx6 = sx[6];
+    sx7 = s7[1];
+    cx7 = c7[1];
+    s2x7 = s7[2];
+    c2x7 = c7[2];
+    s3x7 = s7[3];
+    c3x7 = c7[3];
+    s4x7 = s7[4];
+    c4x7 = c7[4];
+    c5x7 = c7[5];
 
     *dml = (3.31364e-1-(1.0281e-2+4.692e-3*x1)*x1)*sx5+
            (3.228e-3-(6.4436e-2-2.075e-3*x1)*x1)*cx5-
@@ -404,44 +482,52 @@ double t, s;
 double *dml, *ds, *dm, *da, *dhl;
 {
     double dp;
-    double x1, x2, x3, x4, x5, x6, x7, x8;
+    double x1;
+    double sx[7], cx[7];
+    double s3[5], c3[5], s5[3], c5[3], s7[6], c7[6], s8[4], c8[4];
     double sx3, cx3, s2x3, c2x3, s3x3, c3x3, s4x3, c4x3;
     double sx5, cx5, s2x5, c2x5;
     double sx6;
     double sx7, cx7, s2x7, c2x7, s3x7, c3x7, s4x7, c4x7, c5x7, s5x7;
     double s2x8, c2x8, s3x8, c3x8;
 
-    aux_jsun (t, &x1, &x2, &x3, &x4, &x5, &x6);
-    x7 = x3-x2;
-    sx3 = sin(x3);
-    cx3 = cos(x3);
-    s2x3 = sin(2*x3);
-    c2x3 = cos(2*x3);
-    sx5 = sin(x5);
-    cx5 = cos(x5);
-    s2x5 = sin(2*x5);
-    sx6 = sin(x6);
-    sx7 = sin(x7);
-    cx7 = cos(x7);
-    s2x7 = sin(2*x7);
-    c2x7 = cos(2*x7);
-    s3x7 = sin(3*x7);
-    c3x7 = cos(3*x7);
-    s4x7 = sin(4*x7);
-    c4x7 = cos(4*x7);
-    c5x7 = cos(5*x7);
-
-    s3x3 = sin(3*x3);
-    c3x3 = cos(3*x3);
-    s4x3 = sin(4*x3);
-    c4x3 = cos(4*x3);
-    c2x5 = cos(2*x5);
-    s5x7 = sin(5*x7);
-    x8 = x4-x3;
-    s2x8 = sin(2*x8);
-    c2x8 = cos(2*x8);
-    s3x8 = sin(3*x8);
-    c3x8 = cos(3*x8);
+    aux_jsun (t, &x1, sx, cx);
+
+    /* x7 = x3 - x2, x8 = x4 - x3 */
+    harmonics (sx[3], cx[3], 4, s3, c3);
+    harmonics (sx[5], cx[5], 2, s5, c5);
+    harmonics (SDIFF(sx[3], cx[3], sx[2], cx[2]),
+               CDIFF(sx[3], cx[3], sx[2], cx[2]), 5, s7, c7);
+    harmonics (SDIFF(sx[4], cx[4], sx[3], cx[3]),
+               CDIFF(sx[4], cx[4], sx[3], cx[3]), 3, s8, c8);
+    sx3 = s3[1];
+    cx3 = c3[1];
+    s2x3 = s3[2];
+    c2x3 = c3[2];
+    sx5 = s5[1];
+    cx5 = c5[1];
+    s2x5 = s5[2];
+    sx6 = sx[6];
+    sx7 = s7[1];
+    cx7 = c7[1];
+    s2x7 = s7[2];
+    c2x7 = c7[2];
+    s3x7 = s7[3];
+    c3x7 = c7[3];
+    s4x7 = s7[4];
+    c4x7 = c7[4];
+    c5x7 = c7[5];
+
+    s3x3 = s3[3];
+    c3x3 = c3[3];
+    s4x3 = s3[4];
+    c4x3 = c3[4];
+    c2x5 = c5[2];
+    s5x7 = s7[5];
+    s2x8 = s8[2];
+    c2x8 = c8[2];
+    s3x8 = s8[3];
+    c3x8 = c8[3];
 
     *dml = 7.581e-3*s2x5-7.986e-3*sx6-1.48811e-1*sx7-4.0786e-2*s2x7-
            (8.14181e-1-(1.815e-2-1.6714e-2*x1)*x1)*sx5-
@@ -510,27 +596,39 @@ double t, s;
 double *dl, *dr, *dml, *ds, *dm, *da, *dhl;
 {
     double dp;
-    double x1, x2, x3, x4, x5, x6;
-    double x8, x9, x10, x11, x12;
+    double x1, x8;
+    double sx[7], cx[7];
+    double s4[3], c4[3], s8[3], c8[3], s9[3], c9[3], s11[5], c11[5];
+    double s12[5], c12[5];
     double sx4, cx4, s2x4, c2x4;
     double sx9, cx9, s2x9, c2x9;
+    double sx10, cx10;
     double sx11, cx11;
 
-    aux_jsun (t, &x1, &x2, &x3, &x4, &x5, &x6);
+    aux_jsun (t, &x1, sx, cx);
 
     x8 = mod2PI(1.46205+3.81337*t);
-    x9 = 2*x8-x4;
-    sx9 = sin(x9);
-    cx9 = cos(x9);
-    s2x9 = sin(2*x9);
-    c2x9 = cos(2*x9);
-
-    x10 = x4-x2;
-    x11 = x4-x3;
-    x12 = x8-x4;
+    harmonics (sin(x8), cos(x8), 2, s8, c8);
+    harmonics (sx[4], cx[4], 2, s4, c4);
+
+    /* x9 = 2*x8 - x4 */
+    harmonics (SDIFF(s8[2], c8[2], sx[4], cx[4]),
+               CDIFF(s8[2], c8[2], sx[4], cx[4]), 2, s9, c9);
+    sx9 = s9[1];
+    cx9 = c9[1];
+    s2x9 = s9[2];
+    c2x9 = c9[2];
+
+    /* x10 = x4 - x2, x11 = x4 - x3, x12 = x8 - x4 */
+    sx10 = SDIFF(sx[4], cx[4], sx[2], cx[2]);
+    cx10 = CDIFF(sx[4], cx[4], sx[2], cx[2]);
+    harmonics (SDIFF(sx[4], cx[4], sx[3], cx[3]),
+               CDIFF(sx[4], cx[4], sx[3], cx[3]), 4, s11, c11);
+    harmonics (SDIFF(s8[1], c8[1], sx[4], cx[4]),
+               CDIFF(s8[1], c8[1], sx[4], cx[4]), 4, s12, c12);
 
     *dml = (8.64319e-1-1.583e-3*x1)*sx9+(8.2222e-2-6.833e-3*x1)*cx9+
-           3.6017e-2*s2x9-3.019e-3*c2x9+8.122e-3*sin(x6);
+           3.6017e-2*s2x9-3.019e-3*c2x9+8.122e-3*sx[6];
     *dml = degrad(*dml);
 
     dp = 1.20303e-1*sx9+6.197e-3*s2x9+(1.9472e-2-9.47e-4*x1)*cx9;
@@ -541,27 +639,28 @@ double *dl, *dr, *dml, *ds, *dm, *da, *dhl;
 
     *da = -3.825e-3*cx9;
 
-    *dl = (1.0122e-2-9.88e-4*x1)*sin(x4+x11)+
-          (-3.8581e-2+(2.031e-3-1.91e-3*x1)*x1)*cos(x4+x11)+
-          (3.4964e-2-(1.038e-3-8.68e-4*x1)*x1)*cos(2*x4+x11)+
-          5.594e-3*sin(x4+3*x12)-1.4808e-2*sin(x10)-
-          5.794e-3*sin(x11)+2.347e-3*cos(x11)+9.872e-3*sin(x12)+
-          8.803e-3*sin(2*x12)-4.308e-3*sin(3*x12);
-
-    sx11 = sin(x11);
-    cx11 = cos(x11);
-    sx4 = sin(x4);
-    cx4 = cos(x4);
-    s2x4 = sin(2*x4);
-    c2x4 = cos(2*x4);
-    *dhl = (4.58e-4*sx11-6.42e-4*cx11-5.17e-4*cos(4*x12))*sx4-
-           (3.47e-4*sx11+8.53e-4*cx11+5.17e-4*sin(4*x11))*cx4+
-           4.03e-4*(cos(2*x12)*s2x4+sin(2*x12)*c2x4);
+    sx11 = s11[1];
+    cx11 = c11[1];
+    sx4 = s4[1];
+    cx4 = c4[1];
+    s2x4 = s4[2];
+    c2x4 = c4[2];
+
+    *dl = (1.0122e-2-9.88e-4*x1)*SSUM(sx4, cx4, sx11, cx11)+
+          (-3.8581e-2+(2.031e-3-1.91e-3*x1)*x1)*CSUM(sx4, cx4, sx11, cx11)+
+          (3.4964e-2-(1.038e-3-8.68e-4*x1)*x1)*CSUM(s2x4, c2x4, sx11, cx11)+
+          5.594e-3*SSUM(sx4, cx4, s12[3], c12[3])-1.4808e-2*sx10-
+          5.794e-3*sx11+2.347e-3*cx11+9.872e-3*s12[1]+
+          8.803e-3*s12[2]-4.308e-3*s12[3];
+
+    *dhl = (4.58e-4*sx11-6.42e-4*cx11-5.17e-4*c12[4])*sx4-
+           (3.47e-4*sx11+8.53e-4*cx11+5.17e-4*s11[4])*cx4+
+           4.03e-4*(c12[2]*s2x4+s12[2]*c2x4);
     *dhl = degrad(*dhl);
 
-    *dr = -25948+4985*cos(x10)-1230*cx4+3354*cos(x11)+904*cos(2*x12)+
-          894*(cos(x12)-cos(3*x12))+(5795*cx4-1165*sx4+1388*c2x4)*sx11+
-          (1351*cx4+5702*sx4+1388*s2x4)*cos(x11);
+    *dr = -25948+4985*cx10-1230*cx4+3354*cx11+904*c12[2]+
+          894*(c12[1]-c12[3])+(5795*cx4-1165*sx4+1388*c2x4)*sx11+
+          (1351*cx4+5702*sx4+1388*s2x4)*cx11;
     *dr *= 1e-6;
 }
 
@@ -572,24 +671,34 @@ double t, s;
 double *dl, *dr, *dml, *ds, *dm, *da, *dhl;
 {
     double dp;
-    double x1, x2, x3, x4, x5, x6;
-    double x8, x9, x10, x11, x12;
+    double x1, x8;
+    double sx[7], cx[7];
+    double s8[3], c8[3], s9[3], c9[3], s12[3], c12[3];
     double sx8, cx8;
     double sx9, cx9, s2x9, c2x9;
+    double sx10, cx10, sx11, cx11;
     double s2x12, c2x12;
 
-    aux_jsun (t, &x1, &x2, &x3, &x4, &x5, &x6);
+    aux_jsun (t, &x1, sx, cx);
 
     x8 = mod2PI(1.46205+3.81337*t);
-    x9 = 2*x8-x4;
-    sx9 = sin(x9);
-    cx9 = cos(x9);
-    s2x9 = sin(2*x9);
-    c2x9 = cos(2*x9);
-
-    x10 = x8-x2;
-    x11 = x8-x3;
-    x12 = x8-x4;
+    harmonics (sin(x8), cos(x8), 2, s8, c8);
+
+    /* x9 = 2*x8 - x4 */
+    harmonics (SDIFF(s8[2], c8[2], sx[4], cx[4]),
+               CDIFF(s8[2], c8[2], sx[4], cx[4]), 2, s9, c9);
+    sx9 = s9[1];
+    cx9 = c9[1];
+    s2x9 = s9[2];
+    c2x9 = c9[2];
+
+    /* x10 = x8 - x2, x11 = x8 - x3, x12 = x8 - x4 */
+    sx10 = SDIFF(s8[1], c8[1], sx[2], cx[2]);
+    cx10 = CDIFF(s8[1], c8[1], sx[2], cx[2]);
+    sx11 = SDIFF(s8[1], c8[1], sx[3], cx[3]);
+    cx11 = CDIFF(s8[1], c8[1], sx[3], cx[3]);
+    harmonics (SDIFF(s8[1], c8[1], sx[4], cx[4]),
+               CDIFF(s8[1], c8[1], sx[4], cx[4]), 2, s12, c12);
 
     *dml = (1.089e-3*x1-5.89833e-1)*sx9+(4.658e-3*x1-5.6094e-2)*cx9-
            2.4286e-2*s2x9;
@@ -605,16 +714,16 @@ double *dl, *dr, *dml, *ds, *dm, *da, *dhl;
     *da = 8189*cx9-817*sx9+781*c2x9;
     *da *= 1e-6;
 
-    s2x12 = sin(2*x12);
-    c2x12 = cos(2*x12);
-    sx8 = sin(x8);
-    cx8 = cos(x8);
-    *dl = -9.556e-3*sin(x10)-5.178e-3*sin(x11)+2.572e-3*s2x12-
+    s2x12 = s12[2];
+    c2x12 = c12[2];
+    sx8 = s8[1];
+    cx8 = c8[1];
+    *dl = -9.556e-3*sx10-5.178e-3*sx11+2.572e-3*s2x12-
           2.972e-3*c2x12*sx8-2.833e-3*s2x12*cx8;
 
     *dhl = 3.36e-4*c2x12*sx8+3.64e-4*s2x12*cx8;
     *dhl = degrad(*dhl);
 
-    *dr = -40596+4992*cos(x10)+2744*cos(x11)+2044*cos(x12)+1051*c2x12;
+    *dr = -40596+4992*cx10+2744*cx11+2044*c12[1]+1051*c2x12;
     *dr *= 1e-6;
 }
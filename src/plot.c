@@ -7,6 +7,7 @@
  * format of the plot file is one line per coordinate: label,x,y
  * if z was specified, it is a fourth field.
  * x,y,z are plotted using %g format.
+ * or, the file may be written as packed binary records; see binio.h.
  */
 
 #include <stdio.h>
@@ -14,9 +15,14 @@
 #include <string.h>
 #include <math.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 
 #include "screen.h"
 #include "ephem.h"
+#include "binio.h"
 
 #ifdef VMS
 #include <perror.h>
@@ -31,14 +37,14 @@
 
 #define	TRACE(x)	{FILE *fp = fopen("trace","a"); fprintf x; fclose(fp);}
 
-#define	MAXPLTLINES	10	/* max number of labeled lines we can track.
-				 * note we can't store more than NFLOGS fields
-				 * anyway (see flog.c).
-				 */
+#define	PLTCHUNK	16	/* grow pltlines[] by this many at once */
 #define	FNLEN		(14+1)	/* longest filename; plus 1 for \0 */
+#define	PV_NCKP		1024	/* max checkpoints into a viewed plot file */
 
 static char plt_filename[FNLEN] = "ephem.plt";	/* default plot file name */
 static FILE *plt_fp;		/* the plot file; == 0 means don't plot */
+static BinFile *plt_bp;		/* or the binary plot file */
+static int plt_format;		/* BIN_TEXT, BIN_PACKED or BIN_GZIP */
 
 /* store the label and rcfpack()s for each line to track. */
 typedef struct
@@ -46,18 +52,50 @@ typedef struct
     char pl_label;
     int pl_rcpx, pl_rcpy, pl_rcpz;
 } PltLine;
-static PltLine pltlines[MAXPLTLINES];
+static PltLine *pltlines;	/* malloced array of lines to plot */
 static int npltlines;		/* number of pltlines[] in actual use */
+static int mpltlines;		/* number of pltlines[] allocated */
 
 static int plt_in_polar;	/*if true plot in polar coords, else cartesian*/
 static int pltsrchfld;		/* set when the Search field is to be plotted */
 
+/* a plot file being read back, in either format */
+typedef struct
+{
+    FILE *pr_fp;		/* text file, or */
+    BinFile *pr_bp;		/* binary file */
+} PltRdr;
+
 static void plt_select_fields();
 static void plt_turn_off();
 static void plt_turn_on();
 static void plt_file();
-static void plot_cartesian (FILE *pfp);
-static void plot_polar (FILE *pfp);
+/* a plot file mapped into memory for viewing, with a sparse index of where
+ * every pv_stride'th point starts so any part of it may be reached quickly.
+ */
+typedef struct
+{
+    char *pv_base;		/* the whole file */
+    long pv_len;		/* bytes at pv_base */
+    int pv_bin;			/* set if binary, else text */
+    long pv_off;		/* offset of next point to read */
+    long pv_npts;		/* total points in file */
+    long pv_ckp[PV_NCKP];	/* offset of point i*pv_stride */
+    int pv_nckp;		/* entries in pv_ckp[] in use */
+    long pv_stride;		/* points between pv_ckp[] entries */
+} PltView;
+
+static int plt_view (char *fn);
+static int pv_next (PltView *vp, char *cp, double *xp, double *yp);
+static void pv_seek (PltView *vp, long k);
+static void pv_index (PltView *vp, double rng[4]);
+static void pv_range (PltView *vp, long k0, long n, double rng[4]);
+static void pv_draw (PltView *vp, long k0, long n, double rng[4],
+                     int *cnt, char *lbl, int bycount);
+static int plt_read (PltRdr *rp, char *cp, double *xp, double *yp);
+static void plt_rewind (PltRdr *rp);
+static void plot_cartesian (PltRdr *rp);
+static void plot_polar (PltRdr *rp);
 
 /* picked the Plot label:
  * if on, just turn it off.
@@ -66,19 +104,20 @@ static void plot_polar (FILE *pfp);
  */
 void plot_setup()
 {
-    if (plt_fp)
+    if (plot_ison())
         plt_turn_off();
     else
     {
-        static char *chcs[4] =
+        static char *chcs[5] =
         {
-            "Select fields", "Display a plot file", (char *)0,
+            "Select fields", "Display a plot file", (char *)0, (char *)0,
             "Begin plotting"
         };
         static int fn;	/* start with 0, then remember for next time */
 ask:
         chcs[2] = plt_in_polar ? "Polar coords" : "Cartesian coords";
-        switch (popup(chcs, fn, npltlines > 0 ? 4 : 3))
+        chcs[3] = bin_fmtname (plt_format);
+        switch (popup(chcs, fn, npltlines > 0 ? 5 : 4))
         {
         case 0:
             fn = 0;
@@ -94,6 +133,10 @@ ask:
             goto ask;
         case 3:
             fn = 3;
+            plt_format = bin_nextfmt (plt_format);
+            goto ask;
+        case 4:
+            fn = 4;
             plt_turn_on();
             break;
         default:
@@ -105,10 +148,10 @@ ask:
 /* write the active plotfields to the current plot file, if one is open. */
 void plot()
 {
-    if (plt_fp)
+    if (plot_ison())
     {
         PltLine *plp;
-        double x, y, z;
+        double v[3];
         if (!srch_ison() && pltsrchfld)
         {
             /* if searching is not on but we are plotting the search
@@ -131,14 +174,20 @@ void plot()
         /* plot in order of original selection */
         for (plp = pltlines; plp < &pltlines[npltlines]; plp++)
         {
-            if (flog_get (plp->pl_rcpx, &x, (char *)0) == 0
-                    && flog_get (plp->pl_rcpy, &y, (char *)0) == 0)
+            if (flog_get (plp->pl_rcpx, &v[0], (char *)0) == 0
+                    && flog_get (plp->pl_rcpy, &v[1], (char *)0) == 0)
             {
-                (void) fprintf (plt_fp, "%c,%.12g,%.12g", plp->pl_label,
-                                x, y);
-                if (flog_get (plp->pl_rcpz, &z, (char *)0) == 0)
-                    (void) fprintf (plt_fp, ",%.12g", z);
-                (void) fprintf (plt_fp, "\n");
+                int n = flog_get (plp->pl_rcpz, &v[2], (char *)0) == 0 ? 3:2;
+                PROF_IN(PF_FILE);
+                if (plt_bp)
+                    bin_rec (plt_bp, plp->pl_label, n, v);
+                else if (n == 3)
+                    (void) fprintf (plt_fp, "%c,%.12g,%.12g,%.12g\n",
+                                    plp->pl_label, v[0], v[1], v[2]);
+                else
+                    (void) fprintf (plt_fp, "%c,%.12g,%.12g\n",
+                                    plp->pl_label, v[0], v[1]);
+                PROF_OUT(PF_FILE);
             }
         }
     }
@@ -148,7 +197,7 @@ void plot_prstate (force)
 int force;
 {
     static int last;
-    int this = plt_fp != 0;
+    int this = plot_ison();
 
     if (force || this != last)
     {
@@ -159,7 +208,14 @@ int force;
 
 int plot_ison()
 {
-    return (plt_fp != 0);
+    return (plt_fp != 0 || plt_bp != 0);
+}
+
+/* turn plotting off if it is on, so the file is complete, as on exit. */
+void plot_close()
+{
+    if (plot_ison())
+        plt_turn_off();
 }
 
 static
@@ -194,8 +250,23 @@ void plt_select_fields()
     int tmpf;
 
     plt_reset();
-    for (i = 0; i < MAXPLTLINES; i++)
+    for (i = 0; ; i++)
     {
+        if (i == mpltlines)
+        {
+            int newm = mpltlines + PLTCHUNK;
+            PltLine *newp = (PltLine *) realloc ((char *)pltlines,
+                                                 newm*sizeof(PltLine));
+            if (!newp)
+            {
+                f_msg (sry);
+                break;
+            }
+            pltlines = newp;
+            mpltlines = newm;
+        }
+        pltlines[i].pl_rcpx = pltlines[i].pl_rcpy = pltlines[i].pl_rcpz = 0;
+
         (void) sprintf (buf, "select x field for line %d", i+1);
         f = sel_fld (f, alt_menumask()|F_PLT, buf, hlp);
         if (!f)
@@ -243,13 +314,14 @@ void plt_select_fields()
             f = tmpf;
         }
 
+        /* not *, which marks a title in plot files */
         do
         {
             (void) sprintf(buf,"enter a one-character label for line %d: ",
                            i+1);
             f_prompt (buf);
         }
-        while (read_line (buf, 1) != 1);
+        while (read_line (buf, 1) != 1 || *buf == '*');
         pltlines[i].pl_label = *buf;
     }
     npltlines = i;
@@ -258,7 +330,14 @@ void plt_select_fields()
 static
 void plt_turn_off ()
 {
-    (void) fclose (plt_fp);
+    if (plt_bp)
+    {
+        if (bin_close (plt_bp) < 0)
+            f_msg ("Error writing plot file.");
+        plt_bp = 0;
+    }
+    else
+        (void) fclose (plt_fp);
     plt_fp = 0;
     plot_prstate(0);
 }
@@ -317,21 +396,71 @@ void plt_turn_on ()
     }
 
     /* plotting is on if file opens ok */
-    plt_fp = fopen (plt_filename, optype);
-    if (!plt_fp)
+    if (plt_format != BIN_TEXT)
     {
         char buf[NC];
-        (void) sprintf (buf, "can not open %s: %s", plt_filename, errsys);
-        f_prompt (buf);
-        (void)read_char();
+        char (*names)[32] = (char (*)[32]) malloc (3*npltlines*32 + 1);
+        char **np = (char **) malloc (3*npltlines*sizeof(char *) + 1);
+        int nn = 0;
+
+        if (!names || !np)
+        {
+            f_msg ("Sorry; no memory for field names.");
+            if (names) free ((char *)names);
+            if (np) free ((char *)np);
+            return;
+        }
+
+        /* name each field by its line label, axis and screen location */
+        for (plp = pltlines; plp < &pltlines[npltlines]; plp++)
+        {
+            int *rcp[3];
+            int i;
+            rcp[0] = &plp->pl_rcpx;
+            rcp[1] = &plp->pl_rcpy;
+            rcp[2] = &plp->pl_rcpz;
+            for (i = 0; i < 3; i++)
+                if (*rcp[i])
+                {
+                    (void) sprintf (names[nn], "%c %c %d,%d", plp->pl_label,
+                                    "xyz"[i], unpackr(*rcp[i]),
+                                    unpackc(*rcp[i]));
+                    np[nn] = names[nn];
+                    nn++;
+                }
+        }
+        plt_bp = bin_create (plt_filename, optype, plt_format == BIN_GZIP,
+                             "plot", nn, np, buf);
+        free ((char *)names);
+        free ((char *)np);
+        if (!plt_bp)
+            f_msg (buf);
     }
     else
+    {
+        plt_fp = fopen (plt_filename, optype);
+        if (!plt_fp)
+        {
+            char buf[NC];
+            (void) sprintf (buf, "can not open %s: %s", plt_filename, errsys);
+            f_prompt (buf);
+            (void)read_char();
+        }
+        else
+            (void) setvbuf (plt_fp, (char *)0, _IOFBF, BIN_BUFSZ);
+    }
+    if (plot_ison())
     {
         /* add a title if desired */
         static char tp[] = "Title (q to skip): ";
         f_prompt (tp);
         if (read_line (fnq, PW - sizeof(tp)) > 0)
-            (void) fprintf (plt_fp, "* %s\n", fnq);
+        {
+            if (plt_bp)
+                bin_text (plt_bp, fnq);
+            else
+                (void) fprintf (plt_fp, "* %s\n", fnq);
+        }
     }
     plot_prstate (0);
 }
@@ -342,7 +471,7 @@ static
 void plt_file ()
 {
     char fn[FNLEN], fnq[64];
-    FILE *pfp;
+    PltRdr r;
     int n;
 
     /* prompt for file name, giving current as default */
@@ -358,15 +487,35 @@ void plt_file ()
     if (n > 0)
         (void) strcpy (plt_filename, fn);
 
-    /* do the plot if file opens ok */
-    pfp = fopen (plt_filename, "r");
-    if (pfp)
+    /* view it in memory if we can, else read it as a stream */
+    if (plt_view (plt_filename) == 0)
+        return;
+
+    /* do the plot if file opens ok, in whichever format it is */
+    r.pr_fp = 0;
+    r.pr_bp = 0;
+    if (bin_format (plt_filename) > BIN_TEXT)
+    {
+        char buf[NC];
+        r.pr_bp = bin_open (plt_filename, "plot", buf);
+        if (!r.pr_bp)
+        {
+            f_msg (buf);
+            return;
+        }
+    }
+    else
+        r.pr_fp = fopen (plt_filename, "r");
+    if (r.pr_fp || r.pr_bp)
     {
         if (plt_in_polar)
-            plot_polar (pfp);
+            plot_polar (&r);
         else
-            plot_cartesian (pfp);
-        (void) fclose (pfp);
+            plot_cartesian (&r);
+        if (r.pr_bp)
+            (void) bin_close (r.pr_bp);
+        else
+            (void) fclose (r.pr_fp);
     }
     else
     {
@@ -377,26 +526,440 @@ void plt_file ()
     }
 }
 
+/* show the given plot file by mapping it into memory and binning its points
+ * into the screen grid, one pass over the points shown per redraw.
+ * the operator may then page and zoom through it in order of logging,
+ * which is normally time. memory use does not depend on the file size.
+ * return 0 if all done, or -1 if it could not be mapped (such as when
+ * compressed) and so should be read as a stream instead.
+ * N.B. do whatever you like but redraw the screen when done.
+ */
+static int
+plt_view (fn)
+char *fn;
+{
+    static char keys[] = "f/b page, i/o zoom, c count, else quit";
+    PltView *vp;
+    struct stat st;
+    double all[4], rng[4];
+    char buf[NC];
+    int *cnt;
+    char *lbl;
+    long k0, n;
+    int bycount = 0;
+    int fd;
+
+    if (bin_format (fn) == BIN_GZIP)
+        return (-1);
+    if (bin_format (fn) == BIN_PACKED)
+    {
+        /* let bin_open() check it really is a plot file */
+        BinFile *bp = bin_open (fn, "plot", buf);
+        if (!bp)
+        {
+            f_msg (buf);
+            return (0);
+        }
+        (void) bin_close (bp);
+    }
+
+    fd = open (fn, O_RDONLY);
+    if (fd < 0)
+        return (-1);
+    if (fstat (fd, &st) < 0 || st.st_size == 0)
+    {
+        (void) close (fd);
+        return (-1);
+    }
+    vp = (PltView *) calloc (1, sizeof(PltView));
+    cnt = (int *) malloc (NR*NC*sizeof(int));
+    lbl = (char *) malloc (NR*NC);
+    if (vp)
+        vp->pv_base = mmap ((void *)0, st.st_size, PROT_READ, MAP_SHARED,
+                            fd, (off_t)0);
+    (void) close (fd);
+    if (!vp || !cnt || !lbl || vp->pv_base == (char *)MAP_FAILED)
+    {
+        if (vp && vp->pv_base && vp->pv_base != (char *)MAP_FAILED)
+            (void) munmap (vp->pv_base, st.st_size);
+        if (vp) free ((char *)vp);
+        if (cnt) free ((char *)cnt);
+        if (lbl) free (lbl);
+        return (-1);
+    }
+    vp->pv_len = st.st_size;
+    vp->pv_bin = bin_format (fn) == BIN_PACKED;
+
+    f_prompt ("Indexing plot file...");
+    pv_index (vp, all);
+
+#define	SMALL	(1e-10)
+    if (vp->pv_npts < 2 || (!plt_in_polar && (fabs(all[0]-all[1]) < SMALL
+                                            || fabs(all[2]-all[3]) < SMALL)))
+    {
+        f_prompt (plt_in_polar ? "At least two points required to plot."
+                  : "At least two different points required to plot.");
+        (void) read_char();
+    }
+    else
+    {
+        k0 = 0;
+        n = vp->pv_npts;
+        while (1)
+        {
+            if (k0 == 0 && n == vp->pv_npts)
+                (void) memcpy ((char *)rng, (char *)all, sizeof(rng));
+            else
+                pv_range (vp, k0, n, rng);
+            pv_draw (vp, k0, n, rng, cnt, lbl, bycount);
+            (void) sprintf (buf, "%ld-%ld of %ld; %s", k0+1, k0+n,
+                            vp->pv_npts, keys);
+            f_string (NR, (NC-(int)strlen(buf))/2, buf);
+
+            switch (read_char())
+            {
+            case 'f':
+                k0 += n;
+                break;
+            case 'b':
+                k0 -= n;
+                break;
+            case 'i':
+                if (n > 2)
+                {
+                    k0 += n/4;
+                    n /= 2;
+                }
+                break;
+            case 'o':
+                k0 -= n/2;
+                n *= 2;
+                break;
+            case 'c':
+                bycount ^= 1;
+                break;
+            default:
+                goto out;
+            }
+            if (n > vp->pv_npts)
+                n = vp->pv_npts;
+            if (k0 + n > vp->pv_npts)
+                k0 = vp->pv_npts - n;
+            if (k0 < 0)
+                k0 = 0;
+        }
+    }
+out:
+
+    (void) munmap (vp->pv_base, vp->pv_len);
+    free ((char *)vp);
+    free ((char *)cnt);
+    free (lbl);
+    redraw_screen (2);	/* full redraw */
+    return (0);
+}
+
+/* read the point at vp->pv_off and advance past it.
+ * titles and lines that do not parse are skipped.
+ * return 0 if found one, or -1 at eof.
+ */
+static int
+pv_next (vp, cp, xp, yp)
+PltView *vp;
+char *cp;
+double *xp, *yp;
+{
+    if (vp->pv_bin)
+    {
+        double v[2];
+        int tag;
+        int n;
+
+        while ((n = bin_memnext ((unsigned char *)vp->pv_base, vp->pv_len,
+                                 &vp->pv_off, &tag, v, 2)) >= 0)
+            if (tag != '*' && n == 2)
+            {
+                *cp = tag;
+                *xp = v[0];
+                *yp = v[1];
+                return (0);
+            }
+        return (-1);
+    }
+
+    while (vp->pv_off < vp->pv_len)
+    {
+        char buf[128];
+        char *lp = vp->pv_base + vp->pv_off;
+        char *nl = memchr (lp, '\n', vp->pv_len - vp->pv_off);
+        long l = nl ? nl - lp : vp->pv_len - vp->pv_off;
+        char *bp;
+
+        vp->pv_off += nl ? l + 1 : l;
+        if (l >= sizeof(buf))
+            l = sizeof(buf)-1;
+        (void) memcpy (buf, lp, l);
+        buf[l] = '\0';
+
+        /* same as sscanf "%c,%lf,%lf", but quicker */
+        if (l < 2 || buf[1] != ',')
+            continue;
+        *xp = strtod (buf+2, &bp);
+        if (bp == buf+2 || *bp != ',')
+            continue;
+        lp = bp + 1;
+        *yp = strtod (lp, &bp);
+        if (bp == lp)
+            continue;
+        *cp = buf[0];
+        return (0);
+    }
+    return (-1);
+}
+
+/* position vp so pv_next() returns point k next, starting from the nearest
+ * checkpoint before it.
+ */
+static void
+pv_seek (vp, k)
+PltView *vp;
+long k;
+{
+    long j = k / vp->pv_stride;
+    double x, y;
+    char c;
+
+    if (j >= vp->pv_nckp)
+        j = vp->pv_nckp - 1;
+    vp->pv_off = vp->pv_ckp[j];
+    for (j *= vp->pv_stride; j < k; j++)
+        if (pv_next (vp, &c, &x, &y) < 0)
+            break;
+}
+
+/* pass once through the whole file counting the points, filling in the
+ * checkpoints and finding the overall ranges: min x, max x, min y, max y.
+ * checkpoints are kept to PV_NCKP by doubling the stride as needed.
+ */
+static void
+pv_index (vp, rng)
+PltView *vp;
+double rng[4];
+{
+    double x, y;
+    long off, k;
+    char c;
+
+    if (vp->pv_bin)
+        off = bin_memdata ((unsigned char *)vp->pv_base, vp->pv_len);
+    else
+        off = 0;
+    vp->pv_off = off < 0 ? vp->pv_len : off;
+    vp->pv_stride = 1;
+    vp->pv_nckp = 0;
+    rng[0] = rng[1] = rng[2] = rng[3] = 0.0;
+
+    for (k = 0; ; k++)
+    {
+        off = vp->pv_off;
+        if (pv_next (vp, &c, &x, &y) < 0)
+            break;
+        if (k % vp->pv_stride == 0)
+        {
+            if (vp->pv_nckp == PV_NCKP)
+            {
+                int i;
+                for (i = 0; i < PV_NCKP/2; i++)
+                    vp->pv_ckp[i] = vp->pv_ckp[2*i];
+                vp->pv_nckp = PV_NCKP/2;
+                vp->pv_stride *= 2;
+            }
+            if (k % vp->pv_stride == 0)
+                vp->pv_ckp[vp->pv_nckp++] = off;
+        }
+        if (k == 0)
+        {
+            rng[0] = rng[1] = x;
+            rng[2] = rng[3] = y;
+        }
+        else
+        {
+            if (x < rng[0]) rng[0] = x;
+            if (x > rng[1]) rng[1] = x;
+            if (y < rng[2]) rng[2] = y;
+            if (y > rng[3]) rng[3] = y;
+        }
+    }
+    vp->pv_npts = k;
+}
+
+/* find the ranges of the n points starting with point k0, as pv_index().
+ * widen any range that is too small to plot.
+ */
+static void
+pv_range (vp, k0, n, rng)
+PltView *vp;
+long k0, n;
+double rng[4];
+{
+    double x, y;
+    long k;
+    char c;
+
+    rng[0] = rng[1] = rng[2] = rng[3] = 0.0;
+    pv_seek (vp, k0);
+    for (k = 0; k < n && pv_next (vp, &c, &x, &y) == 0; k++)
+        if (k == 0)
+        {
+            rng[0] = rng[1] = x;
+            rng[2] = rng[3] = y;
+        }
+        else
+        {
+            if (x < rng[0]) rng[0] = x;
+            if (x > rng[1]) rng[1] = x;
+            if (y < rng[2]) rng[2] = y;
+            if (y > rng[3]) rng[3] = y;
+        }
+    for (k = 0; k < 4; k += 2)
+        if (rng[k+1] - rng[k] < SMALL)
+        {
+            rng[k] -= 1.0;
+            rng[k+1] += 1.0;
+        }
+}
+
+/* bin the n points starting with point k0 into the screen grid, then draw
+ * each cell used just once: with the label of the last point to land in
+ * it or, if bycount, with how many did (* if more than 9).
+ * first numeric field is x and second y, or r and theta in degrees if
+ * plt_in_polar.
+ */
+static void
+pv_draw (vp, k0, n, rng, cnt, lbl, bycount)
+PltView *vp;
+long k0, n;
+double rng[4];
+int *cnt;
+char *lbl;
+int bycount;
+{
+    double maxr = rng[1];
+    double x, y;
+    int row, col;
+    long k;
+    char c;
+
+    (void) memset ((char *)cnt, 0, NR*NC*sizeof(int));
+    pv_seek (vp, k0);
+    for (k = 0; k < n && pv_next (vp, &c, &x, &y) == 0; k++)
+    {
+        if (plt_in_polar)
+        {
+            double r = x, th = y;
+            x = r * cos(th/57.2958);	/* degs to rads */
+            y = r * sin(th/57.2958);
+            row = NR-(int)((NR-1)*(y+maxr)/(2.0*maxr)+0.5);
+            col =  1+(int)((NC-1)*(x+maxr)/(2.0*maxr)/ASPECT+0.5);
+        }
+        else
+        {
+            row = NR-(int)((NR-1)*(y-rng[2])/(rng[3]-rng[2])+0.5);
+            col =  1+(int)((NC-1)*(x-rng[0])/(rng[1]-rng[0])+0.5);
+        }
+        if (row < 1 || row > NR || col < 1 || col > NC)
+            continue;
+        if (row == NR && col == NC)
+            col--;	/* avoid lower right scrolling corner */
+        cnt[(row-1)*NC + col-1]++;
+        lbl[(row-1)*NC + col-1] = c;
+    }
+
+    c_erase();
+    for (row = 1; row <= NR; row++)
+        for (col = 1; col <= NC; col++)
+        {
+            int i = (row-1)*NC + col-1;
+            if (cnt[i])
+                f_char (row, col, !bycount ? lbl[i]
+                        : cnt[i] > 9 ? '*' : '0' + cnt[i]);
+        }
+
+    /* label axes */
+    if (plt_in_polar)
+        f_double (NR/2, NC-10, "%g", maxr);
+    else
+    {
+        f_double (1, 1, "%g", rng[3]);
+        f_double (NR-1, 1, "%g", rng[2]);
+        f_double (NR, 1, "%g", rng[0]);
+        f_double (NR, NC-10, "%g", rng[1]);
+    }
+}
+
+/* read the next point from a plot file of either format.
+ * titles and lines that do not parse are skipped.
+ * return 0 if found one, or -1 at eof.
+ */
+static int
+plt_read (rp, cp, xp, yp)
+PltRdr *rp;
+char *cp;
+double *xp, *yp;
+{
+    if (rp->pr_bp)
+    {
+        double v[2];
+        int tag;
+        int n;
+
+        while ((n = bin_next (rp->pr_bp, &tag, v, 2, (char *)0, 0)) >= 0)
+            if (tag != '*' && n == 2)
+            {
+                *cp = tag;
+                *xp = v[0];
+                *yp = v[1];
+                return (0);
+            }
+    }
+    else
+    {
+        char buf[128];
+
+        while (fgets (buf, sizeof(buf), rp->pr_fp))
+            if (sscanf (buf, "%c,%lf,%lf", cp, xp, yp) == 3)
+                return (0);
+    }
+    return (-1);
+}
+
+/* go back to the first point of a plot file. */
+static void
+plt_rewind (rp)
+PltRdr *rp;
+{
+    if (rp->pr_bp)
+        (void) bin_rewind (rp->pr_bp);
+    else
+        rewind (rp->pr_fp);
+}
+
 /* plot the given file on the screen in cartesian coords.
  * TODO: add z tags somehow
  * N.B. do whatever you like but redraw the screen when done.
  */
 static
-void plot_cartesian (pfp)
-FILE *pfp;
+void plot_cartesian (rp)
+PltRdr *rp;
 {
-    static char fmt[] = "%c,%lf,%lf";
-    double x, y;	/* N.B. be sure these match what scanf's %lf wants*/
+    double x, y;
     double minx, maxx, miny, maxy;
-    char buf[128];
     int npts = 0;
     char c;
 
     /* find ranges and number of points */
-    while (fgets (buf, sizeof(buf), pfp))
+    while (plt_read (rp, &c, &x, &y) == 0)
     {
-        if (sscanf (buf, fmt, &c, &x, &y) != 3)
-            continue;
         if (npts++ == 0)
         {
             maxx = minx = x;
@@ -417,13 +980,11 @@ FILE *pfp;
     else
     {
         /* read file again, this time plotting */
-        rewind (pfp);
+        plt_rewind (rp);
         c_erase();
-        while (fgets (buf, sizeof(buf), pfp))
+        while (plt_read (rp, &c, &x, &y) == 0)
         {
             int row, col;
-            if (sscanf (buf, fmt, &c, &x, &y) != 3)
-                continue;
             row = NR-(int)((NR-1)*(y-miny)/(maxy-miny)+0.5);
             col =  1+(int)((NC-1)*(x-minx)/(maxx-minx)+0.5);
             if (row == NR && col == NC)
@@ -449,21 +1010,17 @@ FILE *pfp;
  * N.B. do whatever you like but redraw the screen when done.
  */
 static
-void plot_polar (pfp)
-FILE *pfp;
+void plot_polar (rp)
+PltRdr *rp;
 {
-    static char fmt[] = "%c,%lf,%lf";
-    double r, th;	/* N.B. be sure these match what scanf's %lf wants*/
+    double r, th;
     double maxr;
-    char buf[128];
     int npts = 0;
     char c;
 
     /* find ranges and number of points */
-    while (fgets (buf, sizeof(buf), pfp))
+    while (plt_read (rp, &c, &r, &th) == 0)
     {
-        if (sscanf (buf, fmt, &c, &r, &th) != 3)
-            continue;
         if (npts++ == 0)
             maxr = r;
         else if (r > maxr)
@@ -475,14 +1032,12 @@ FILE *pfp;
     else
     {
         /* read file again, this time plotting */
-        rewind (pfp);
+        plt_rewind (rp);
         c_erase();
-        while (fgets (buf, sizeof(buf), pfp))
+        while (plt_read (rp, &c, &r, &th) == 0)
         {
             int row, col;
             double x, y;
-            if (sscanf (buf, fmt, &c, &r, &th) != 3)
-                continue;
             x = r * cos(th/57.2958);	/* degs to rads */
             y = r * sin(th/57.2958);
             row = NR-(int)((NR-1)*(y+maxr)/(2.0*maxr)+0.5);
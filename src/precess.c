@@ -8,6 +8,8 @@
 #define	DASIN(x)	raddeg(asin(x))
 #define	DATAN2(y,x)	raddeg(atan2((y),(x)))
 
+static void p2000 (double yr, double m[3][3]);
+
 /* corrects ra and dec, both in radians, for precession from epoch 1 to epoch 2.
  * the epochs are given by their modified JDs, mjd1 and mjd2, respectively.
  * N.B. ra and dec are modifed IN PLACE.
@@ -31,70 +33,157 @@ void precess (mjd1, mjd2, ra, dec)
 double mjd1, mjd2;	/* initial and final epoch modified JDs */
 double *ra, *dec;	/* ra/dec for mjd1 in, for mjd2 out */
 {
-    double zeta_A, z_A, theta_A;
+    precess_n (mjd1, mjd2, 1, ra, dec);
+}
+
+/* precess() for each of the n positions ra[] and dec[], IN PLACE.
+ * the precession angles, and the sines and cosines of theta_A, are found once
+ * for all; the results are the same as one at a time.
+ */
+void precess_n (mjd1, mjd2, n, ra, dec)
+double mjd1, mjd2;	/* initial and final epoch modified JDs */
+int n;
+double ra[], dec[];	/* ra/dec for mjd1 in, for mjd2 out */
+{
+    double zeta_A1, z_A1, theta_A1, sth1, cth1;	/* to 2000.0 */
+    double zeta_A2, z_A2, theta_A2, sth2, cth2;	/* from 2000.0 */
     double T;
-    double A, B, C;
-    double alpha, delta;
-    double alpha_in, delta_in;
     double from_equinox, to_equinox;
-    double alpha2000, delta2000;
+    int i;
 
     mjd_year (mjd1, &from_equinox);
     mjd_year (mjd2, &to_equinox);
-    alpha_in = raddeg(*ra);
-    delta_in = raddeg(*dec);
 
-    /* From from_equinox to 2000.0 */
+    zeta_A1 = z_A1 = sth1 = cth1 = 0.0;
     if (from_equinox != 2000.0)
     {
         T = (from_equinox - 2000.0)/100.0;
-        zeta_A  = 0.6406161* T + 0.0000839* T*T + 0.0000050* T*T*T;
-        z_A     = 0.6406161* T + 0.0003041* T*T + 0.0000051* T*T*T;
-        theta_A = 0.5567530* T - 0.0001185* T*T + 0.0000116* T*T*T;
-
-        A = DSIN(alpha_in - z_A) * DCOS(delta_in);
-        B = DCOS(alpha_in - z_A) * DCOS(theta_A) * DCOS(delta_in)
-            + DSIN(theta_A) * DSIN(delta_in);
-        C = -DCOS(alpha_in - z_A) * DSIN(theta_A) * DCOS(delta_in)
-            + DCOS(theta_A) * DSIN(delta_in);
-
-        alpha2000 = DATAN2(A,B) - zeta_A;
-        range (&alpha2000, 360.0);
-        delta2000 = DASIN(C);
+        zeta_A1  = 0.6406161* T + 0.0000839* T*T + 0.0000050* T*T*T;
+        z_A1     = 0.6406161* T + 0.0003041* T*T + 0.0000051* T*T*T;
+        theta_A1 = 0.5567530* T - 0.0001185* T*T + 0.0000116* T*T*T;
+        sth1 = DSIN(theta_A1);
+        cth1 = DCOS(theta_A1);
     }
-    else
-    {
-        /* should get the same answer, but this could improve accruacy */
-        alpha2000 = alpha_in;
-        delta2000 = delta_in;
-    };
-
 
-    /* From 2000.0 to to_equinox */
+    zeta_A2 = z_A2 = sth2 = cth2 = 0.0;
     if (to_equinox != 2000.0)
     {
         T = (to_equinox - 2000.0)/100.0;
-        zeta_A  = 0.6406161* T + 0.0000839* T*T + 0.0000050* T*T*T;
-        z_A     = 0.6406161* T + 0.0003041* T*T + 0.0000051* T*T*T;
-        theta_A = 0.5567530* T - 0.0001185* T*T + 0.0000116* T*T*T;
-
-        A = DSIN(alpha2000 + zeta_A) * DCOS(delta2000);
-        B = DCOS(alpha2000 + zeta_A) * DCOS(theta_A) * DCOS(delta2000)
-            - DSIN(theta_A) * DSIN(delta2000);
-        C = DCOS(alpha2000 + zeta_A) * DSIN(theta_A) * DCOS(delta2000)
-            + DCOS(theta_A) * DSIN(delta2000);
-
-        alpha = DATAN2(A,B) + z_A;
-        range(&alpha, 360.0);
-        delta = DASIN(C);
+        zeta_A2  = 0.6406161* T + 0.0000839* T*T + 0.0000050* T*T*T;
+        z_A2     = 0.6406161* T + 0.0003041* T*T + 0.0000051* T*T*T;
+        theta_A2 = 0.5567530* T - 0.0001185* T*T + 0.0000116* T*T*T;
+        sth2 = DSIN(theta_A2);
+        cth2 = DCOS(theta_A2);
     }
-    else
+
+    for (i = 0; i < n; i++)
     {
-        /* should get the same answer, but this could improve accruacy */
-        alpha = alpha2000;
-        delta = delta2000;
-    };
+        double A, B, C;
+        double alpha, delta;
+        double alpha_in, delta_in;
+        double alpha2000, delta2000;
+
+        alpha_in = raddeg(ra[i]);
+        delta_in = raddeg(dec[i]);
+
+        /* From from_equinox to 2000.0 */
+        if (from_equinox != 2000.0)
+        {
+            A = DSIN(alpha_in - z_A1) * DCOS(delta_in);
+            B = DCOS(alpha_in - z_A1) * cth1 * DCOS(delta_in)
+                + sth1 * DSIN(delta_in);
+            C = -DCOS(alpha_in - z_A1) * sth1 * DCOS(delta_in)
+                + cth1 * DSIN(delta_in);
+
+            alpha2000 = DATAN2(A,B) - zeta_A1;
+            alpha2000 -= 360.0*floor(alpha2000/360.0); /* range 360 */
+            delta2000 = DASIN(C);
+        }
+        else
+        {
+            /* should get the same answer, but this could improve accruacy */
+            alpha2000 = alpha_in;
+            delta2000 = delta_in;
+        };
+
+
+        /* From 2000.0 to to_equinox */
+        if (to_equinox != 2000.0)
+        {
+            A = DSIN(alpha2000 + zeta_A2) * DCOS(delta2000);
+            B = DCOS(alpha2000 + zeta_A2) * cth2 * DCOS(delta2000)
+                - sth2 * DSIN(delta2000);
+            C = DCOS(alpha2000 + zeta_A2) * sth2 * DCOS(delta2000)
+                + cth2 * DSIN(delta2000);
+
+            alpha = DATAN2(A,B) + z_A2;
+            alpha -= 360.0*floor(alpha/360.0); /* range 360 */
+            delta = DASIN(C);
+        }
+        else
+        {
+            /* should get the same answer, but this could improve accruacy */
+            alpha = alpha2000;
+            delta = delta2000;
+        };
+
+        ra[i] = degrad(alpha);
+        dec[i] = degrad(delta);
+    }
+}
+
+/* find the matrix, m, that takes an equatorial unit vector for epoch mjd1 to
+ * one for epoch mjd2, by the same rigorous precession as precess().
+ * a vector (x,y,z) is (cos(dec)cos(ra), cos(dec)sin(ra), sin(dec)).
+ * one matrix then precesses any number of positions with 9 multiplies each.
+ */
+void precess_matrix (mjd1, mjd2, m)
+double mjd1, mjd2;	/* initial and final epoch modified JDs */
+double m[3][3];		/* m[i][j]: row i, column j */
+{
+    double from_equinox, to_equinox;
+    double p1[3][3], p2[3][3];
+    int i, j;
+
+    mjd_year (mjd1, &from_equinox);
+    mjd_year (mjd2, &to_equinox);
+    p2000 (from_equinox, p1);
+    p2000 (to_equinox, p2);
+
+    /* p1 is a rotation so its inverse is its transpose */
+    for (i = 0; i < 3; i++)
+        for (j = 0; j < 3; j++)
+            m[i][j] = p2[i][0]*p1[j][0] + p2[i][1]*p1[j][1]
+                      + p2[i][2]*p1[j][2];
+}
+
+/* the precession matrix from 2000.0 to the decimal year yr */
+static void
+p2000 (yr, m)
+double yr;
+double m[3][3];
+{
+    double T = (yr - 2000.0)/100.0;
+    double zeta_A, z_A, theta_A;
+    double cze, sze, cz, sz, cth, sth;
+
+    zeta_A  = 0.6406161* T + 0.0000839* T*T + 0.0000050* T*T*T;
+    z_A     = 0.6406161* T + 0.0003041* T*T + 0.0000051* T*T*T;
+    theta_A = 0.5567530* T - 0.0001185* T*T + 0.0000116* T*T*T;
+    cze = DCOS(zeta_A);
+    sze = DSIN(zeta_A);
+    cz = DCOS(z_A);
+    sz = DSIN(z_A);
+    cth = DCOS(theta_A);
+    sth = DSIN(theta_A);
 
-    *ra = degrad(alpha);
-    *dec = degrad(delta);
+    m[0][0] = cze*cth*cz - sze*sz;
+    m[0][1] = -sze*cth*cz - cze*sz;
+    m[0][2] = -sth*cz;
+    m[1][0] = cze*cth*sz + sze*cz;
+    m[1][1] = -sze*cth*sz + cze*cz;
+    m[1][2] = -sth*sz;
+    m[2][0] = cze*sth;
+    m[2][1] = -sze*sth;
+    m[2][2] = cth;
 }
@@ -0,0 +1,125 @@
+/* optional counts and times of the main kinds of work, built in only with
+ * -DPROFILE. each PF_* slot in ephem.h counts its calls and adds up the time
+ * from its outermost PROF_IN() to the matching PROF_OUT(), so a slot that is
+ * entered again from within itself is not timed twice. times are inclusive:
+ * riset_cir() includes the body_cir() calls it makes, body_cir() those to
+ * plans() and moon().
+ * the table is appended to PF_PATH when ephem exits and whenever it gets
+ * SIGUSR1, so a long plot or listing run may be looked at as it goes.
+ */
+
+#ifdef PROFILE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include "ephem.h"
+
+#define	PF_PATH		"ephem.prof"	/* where the tables go */
+
+static char *pf_name[PF_N] =
+{
+    "body_cir", "plans", "moon", "riset_cir", "execute_expr", "flog_log",
+    "f_* screen", "tty flush", "file output"
+};
+static long pf_calls[PF_N];	/* times each slot was entered */
+static double pf_secs[PF_N];	/* total seconds in each slot */
+static double pf_t0[PF_N];	/* time_mono() at the outermost entry */
+static int pf_depth[PF_N];	/* current nesting in each slot */
+static double pf_start;		/* time_mono() at prof_init() */
+static volatile int pf_want;	/* set by SIGUSR1 */
+
+static void prof_dump (char *why);
+static void prof_atexit (void);
+static void on_usr1 (int sig);
+
+/* note the start time and arrange for the table to be written on exit and
+ * on SIGUSR1.
+ */
+void prof_init()
+{
+    pf_start = time_mono();
+    (void) atexit (prof_atexit);
+    (void) signal (SIGUSR1, on_usr1);
+}
+
+/* enter slot k */
+void prof_in (k)
+int k;
+{
+    pf_calls[k]++;
+    if (pf_depth[k]++ == 0)
+        pf_t0[k] = time_mono();
+}
+
+/* leave slot k */
+void prof_out (k)
+int k;
+{
+    if (pf_depth[k] > 0 && --pf_depth[k] == 0)
+        pf_secs[k] += time_mono() - pf_t0[k];
+}
+
+/* write the table if SIGUSR1 has asked for one since last time.
+ * called from the main loop, where it is safe to use stdio.
+ */
+void prof_poll()
+{
+    if (pf_want)
+    {
+        pf_want = 0;
+        prof_dump ("SIGUSR1");
+    }
+}
+
+/* forget any slots left open, as by a longjmp() out of a computation */
+void prof_unwind()
+{
+    int k;
+
+    for (k = 0; k < PF_N; k++)
+        pf_depth[k] = 0;
+}
+
+/* append the table to PF_PATH, headed by why it was written */
+static void
+prof_dump (why)
+char *why;
+{
+    double el = time_mono() - pf_start;
+    long calls, evals;
+    FILE *fp;
+    int k;
+
+    fp = fopen (PF_PATH, "a");
+    if (!fp)
+        return;
+    (void) fprintf (fp, "ephem profile, %s, %.3f secs since start\n", why, el);
+    (void) fprintf (fp, "%-14s %12s %12s %12s %7s\n", "what", "calls",
+                    "secs", "usecs/call", "%run");
+    for (k = 0; k < PF_N; k++)
+        (void) fprintf (fp, "%-14s %12ld %12.4f %12.3f %7.2f\n", pf_name[k],
+                        pf_calls[k], pf_secs[k],
+                        pf_calls[k] ? 1e6*pf_secs[k]/pf_calls[k] : 0.0,
+                        el > 0 ? 100.0*pf_secs[k]/el : 0.0);
+    sunpos_counts (&calls, &evals);
+    (void) fprintf (fp, "sunpos %ld calls, %ld worked out\n\n", calls, evals);
+    (void) fclose (fp);
+}
+
+static void
+prof_atexit()
+{
+    prof_dump ("exit");
+}
+
+/* SIGUSR1 handler: just ask for a table at the next prof_poll() */
+static void
+on_usr1 (sig)
+int sig;
+{
+    (void) signal (SIGUSR1, on_usr1);
+    pf_want = 1;
+}
+
+#endif /* PROFILE */
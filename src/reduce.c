@@ -23,6 +23,15 @@ double *om;	/* desired long of ascending node, rads */
     double ot, sot, cot, ot1;
     double seta, ceta;
 
+    /* nothing to do; and the small inclination formula below is 0/0 */
+    if (mjd == mjd0)
+    {
+        *inc = inc0;
+        *ap = ap0;
+        *om = om0;
+        return;
+    }
+
     t0 = mjd0/365250.0;
     t1 = mjd/365250.0;
 
@@ -11,25 +11,33 @@
 
 #define	STDREF	degrad(34./60.)	/* nominal horizon refraction amount */
 #define	TWIREF	degrad(18.)	/* twilight horizon displacement */
+#define	NAUTREF	degrad(12.)	/* nautical twilight horizon displacement */
+#define	CIVREF	degrad(6.)	/* civil twilight horizon displacement */
 #define	TMACC	(15./3600.)	/* convergence accuracy, hours */
+#define	TW_TMACC (1./3600.)	/* same, for twilight_table() */
 
 static void iterative_riset (int p, Now *np, int hzn, double *ltr, double *lts,
                              double *ltt, double *azr, double *azs, double *altt, int *status);
 static void stationary_riset (int p, double mjd0, Now *np, int hzn, double *lstr,
                               double *lsts, double *lstt, double *azr, double *azs, double *altt, int *status);
 static void transit (double r, double d, Now *np, double *lstt, double *altt);
+static void tw_sun (Now *np, double lnoon, double *ra, double *dec,
+                    double *ehp);
+static int tw_event (Now *np, double lst, double ra[3], double dec[3],
+                     double ehp, double dis, int set, double *diff);
 
 /* find where and when a body, p, will rise and set and
  *   it's transit circumstances. all times are local, angles rads e of n.
  * return 0 if just returned same stuff as previous call, else 1 if new.
  * status is set from the RS_* #defines in circum.h.
- * also used to find astro twilight by calling with hzn TWILIGHT.
+ * also used to find twilight by calling with hzn TWILIGHT, NAUTTWI or
+ * CIVILTWI; see also twilight_table() for many days at once.
  */
 int riset_cir (p, np, force, hzn, ltr, lts, ltt, azr, azs, altt, status)
 int p;		/* one of the body defines in astro.h or screen.h */
 Now *np;
 int force;	/* set !=0 to force computations */
-int hzn;	/* STDHZN or ADPHZN or TWILIGHT */
+int hzn;	/* STDHZN, ADPHZN, TWILIGHT, NAUTTWI or CIVILTWI */
 double *ltr, *lts; /* local rise and set times */
 double *ltt;	/* local transit time */
 double *azr, *azs; /* local rise and set azimuths, rads e of n */
@@ -52,6 +60,7 @@ int *status;	/* one or more of the RS_* defines */
     Last *lp;
     int new;
 
+    PROF_IN(PF_RISET);
     lp = last + p;
     if (!force && same_cir (np, &lp->l_now) && same_lday (np, &lp->l_now)
             && lp->l_hzn == hzn)
@@ -80,6 +89,7 @@ int *status;	/* one or more of the RS_* defines */
         lp->l_now = *np;
         new = 1;
     }
+    PROF_OUT(PF_RISET);
     return (new);
 }
 
@@ -266,12 +276,14 @@ int *status;
             dis += degrad (32./60./2.);
         break;
     case TWILIGHT:
+    case NAUTTWI:
+    case CIVILTWI:
         if (p != SUN)
         {
             f_msg ("Non-sun twilight bug!");
             bye();
         }
-        dis = TWIREF;
+        dis = hzn == TWILIGHT ? TWIREF : hzn == NAUTTWI ? NAUTREF : CIVREF;
         break;
     case ADPHZN:
         /* adaptive includes actual refraction conditions and also
@@ -302,3 +314,186 @@ double *altt;	/* local, refracted, altitude at time of transit */
         *altt = PI - *altt;
     refract (pressure, temp, *altt, altt);
 }
+
+/* find the local times of astronomical, nautical and civil dawn and dusk, as
+ * riset_cir() would with hzn TWILIGHT, NAUTTWI and CIVILTWI, for each of the
+ * nd local days starting with that of np, into tw[], indexed by TW_*.
+ * the sun is found just once at each local noon, from the day before the
+ * first to the day after the last; each event is then found by moving it
+ * between those noons by interpolation, so all six of a day cost one sun
+ * position. nothing is kept between calls, so different sites may be done
+ * at once in separate processes.
+ */
+void twilight_table (np, nd, tw)
+Now *np;
+int nd;
+Twilight tw[];
+{
+    static double dis[TW_N] = {TWIREF, NAUTREF, CIVREF};
+    double ra[3], dec[3];	/* sun at the noons before, of and after */
+    double ehp[3];		/* its horizontal parallax then */
+    double lday, lnoon, lst;
+    Now n;
+    int i, k;
+
+    lday = mjd_day (mjd - tz/24.0);
+    lnoon = lday + (12.0 + tz)/24.0;	/* mjd of the first local noon */
+    tw_sun (np, lnoon - 1.0, &ra[0], &dec[0], &ehp[0]);
+    tw_sun (np, lnoon, &ra[1], &dec[1], &ehp[1]);
+
+    for (i = 0; i < nd; i++, lday += 1.0, lnoon += 1.0)
+    {
+        Twilight *wp = &tw[i];
+
+        if (i > 0)
+        {
+            ra[0] = ra[1];
+            dec[0] = dec[1];
+            ehp[0] = ehp[1];
+            ra[1] = ra[2];
+            dec[1] = dec[2];
+            ehp[1] = ehp[2];
+        }
+        tw_sun (np, lnoon + 1.0, &ra[2], &dec[2], &ehp[2]);
+        n.n_mjd = lnoon;
+        n.n_lng = lng;
+        now_lst (&n, &lst);	/* lst at local noon */
+
+        wp->w_lday = lday;
+        for (k = 0; k < TW_N; k++)
+        {
+            double diff;
+            int rss, status = 0;
+
+            /* as in iterative_riset(), the first guess at dawn, with the
+             * sun where it is at noon, also says whether it gets that low
+             * at all.
+             */
+            rss = tw_event (np, lst, ra, dec, ehp[1], dis[k], 0, &diff);
+            if (rss == 0)
+            {
+                wp->w_dawn[k] = 12.0 + diff;
+                if (wp->w_dawn[k] <= 24.0*(1.0-SIDRATE)
+                        || wp->w_dawn[k] >= 24.0*SIDRATE)
+                    status |= RS_2RISES;
+            }
+            else if (rss == 3)
+                status |= RS_NORISE;
+            if (rss == 0 || rss == 3)
+            {
+                rss = tw_event (np, lst, ra, dec, ehp[1], dis[k], 1, &diff);
+                if (rss == 0)
+                {
+                    wp->w_dusk[k] = 12.0 + diff;
+                    if (wp->w_dusk[k] <= 24.0*(1.0-SIDRATE)
+                            || wp->w_dusk[k] >= 24.0*SIDRATE)
+                        status |= RS_2SETS;
+                }
+                else if (rss == 3)
+                {
+                    status |= RS_NOSET;
+                    rss = 0;
+                }
+            }
+            switch (rss)
+            {
+            case  1:
+                status = RS_NEVERUP;
+                break;
+            case -1:
+                status = RS_CIRCUMPOLAR;
+                break;
+            case  2:
+                status = RS_ERROR;
+                break;
+            }
+            wp->w_status[k] = status;
+        }
+    }
+}
+
+/* find the sun's apparent ra and dec of date, and its horizontal parallax,
+ * at mjd lnoon for the site of np.
+ */
+static void
+tw_sun (np, lnoon, ra, dec, ehp)
+Now *np;
+double lnoon;
+double *ra, *dec, *ehp;
+{
+    Now n;
+    Sky s;
+
+    n = *np;
+    n.n_mjd = lnoon;
+    n.n_epoch = EOD;
+    (void) body_cir (SUN, 0.0, &n, &s);
+    *ra = s.s_ra;
+    *dec = s.s_dec;
+    *ehp = s.s_edist > 0 ? (2.*6378./146e6)/s.s_edist : 0.0;
+}
+
+/* find the hours from local noon to a dawn (set 0) or dusk (set 1) of the sun
+ * displaced dis below the horizon, as iterative_riset() does, but with the
+ * sun's ra and dec at each guess taken from a parabola through those at the
+ * noons before, of and after the day. the first guess is the sun at noon.
+ * lst is the local sidereal time at noon, hours.
+ * return 0 and set *diff if ok; else the status from riset() or 3 if the
+ * guesses do not settle.
+ */
+static int
+tw_event (np, lst, ra, dec, ehp, dis, set, diff)
+Now *np;
+double lst;
+double ra[3], dec[3];
+double ehp, dis;
+int set;
+double *diff;
+{
+#define	TW_MAXPASSES	8
+    double rp, rm;	/* ra after and before, less that at noon, rads */
+    double d, lastd, x, az;
+    int pass;
+
+    rp = ra[2] - ra[1];
+    rm = ra[0] - ra[1];
+    rp -= 2*PI*floor(rp/(2*PI) + 0.5);
+    rm -= 2*PI*floor(rm/(2*PI) + 0.5);
+
+    lastd = 1000.0;
+    d = 0.0;
+    for (pass = 0; pass < TW_MAXPASSES; pass++)
+    {
+        double r, dc, l, ha, lstr, lsts;
+        int rss;
+
+        x = d/24.0;		/* days from noon */
+        r = ra[1] + x*(rp - rm)/2 + x*x*(rp + rm)/2;
+        dc = dec[1] + x*(dec[2] - dec[0])/2
+             + x*x*(dec[2] - 2*dec[1] + dec[0])/2;
+
+        /* parallax, at the lst of the guess */
+        l = lst + d/SIDRATE;
+        ha = hrrad(l) - r;
+        ta_par (ha, dc, lat, height, ehp, &ha, &dc);
+        r = hrrad(l) - ha;
+        range (&r, 2*PI);
+
+        riset (r, dc, lat, dis, &lstr, &lsts, &az, &az, &rss);
+        if (rss != 0)
+            return (rss);
+
+        d = ((set ? lsts : lstr) - lst)*SIDRATE;
+        if (d > 12.0)
+            d -= 24.0*SIDRATE;	/* not tomorrow, today */
+        else if (d < -12.0)
+            d += 24.0*SIDRATE;	/* not yesterday, today */
+        if (fabs (d - lastd) < TW_TMACC)
+        {
+            *diff = d;
+            return (0);
+        }
+        lastd = d;
+    }
+    return (3);
+}
@@ -248,6 +248,8 @@ int Colors_Enabled;
 #define	R_EUROPA	(R_JCOLHDNGS+2)
 #define	R_GANYMEDE	(R_JCOLHDNGS+3)
 #define	R_CALLISTO	(R_JCOLHDNGS+4)
+#define	R_JEVENTS	(R_JCOLHDNGS-1)
+#define	C_JEVENTS	C_JMNAMES
 
 #define	PW	(NC-C_PROMPT+1)	/* total prompt line width */
 
@@ -29,6 +29,7 @@ void _init_fields()
     NFIELDS = 0;
 #endif
     _RCFPAK (R_ALTM,	C_ALTM,		F_MMNU|F_CHG),
+    _RCFPAK (R_CAL,	C_CAL,		F_MMNU|F_CHG),
     _RCFPAK (R_CALLISTO,C_JMX,		F_MNUJ|F_PLT),
     _RCFPAK (R_CALLISTO,C_JMY,		F_MNUJ|F_PLT),
     _RCFPAK (R_CALLISTO,C_JMZ,		F_MNUJ|F_PLT),
@@ -49,6 +50,7 @@ void _init_fields()
     _RCFPAK (R_IO,	C_JMZ,		F_MNUJ|F_PLT),
     _RCFPAK (R_JCML,	C_JCMLSI,	F_MNUJ|F_PLT),
     _RCFPAK (R_JCML,	C_JCMLSII,	F_MNUJ|F_PLT),
+    _RCFPAK (R_JEVENTS,	C_JEVENTS,	F_MNUJ|F_CHG),
     _RCFPAK (R_JD,	C_JDV,		F_MMNU|F_CHG|F_PLT),
     _RCFPAK (R_JUPITER,	C_ALT,		F_MNU1|F_PLT),
     _RCFPAK (R_JUPITER,	C_AZ,		F_MNU1|F_PLT),
@@ -5,38 +5,69 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include "screen.h"
 #include "ephem.h"
 
+extern double mjd_day(), mjd_hr();
+
 static int (*srch_f)();
 static int srch_tmscalled;
 static char expbuf[80];		/* [0] == '\0' when expression is invalid */
 static double tmlimit = 1./60.;	/* search accuracy, in hrs; def is one minute */
 
+/* one event found by the Find all search */
+typedef struct
+{
+    double ev_mjd;	/* when */
+    double ev_val;	/* value of the search function then */
+    int ev_kind;	/* one of the EV_ codes */
+} SrchEvent;
+#define	EV_ZERO		0	/* function passed through 0 */
+#define	EV_MAX		1	/* function at a local maximum */
+#define	EV_MIN		2	/* function at a local minimum */
+
+static double fa_window = 365.;	/* Find all scan window, days */
+static int fa_budget = 100;	/* max events Find all will collect */
+static SrchEvent *fa_events;	/* malloced list of events found so far */
+static int fa_nevents;		/* number of fa_events[] in use */
+static int fa_mevents;		/* number of fa_events[] allocated */
+static int fa_active;		/* set while a Find all scan is under way */
+static double fa_mjd0, fa_end;	/* its scan window */
+static double fa_upto;		/* newest scan sample so far */
+
 static void set_function();
 static void set_accuracy();
+static int set_findall();
+static void fa_report(char *why);
+static void fa_stop(char *why);
 static int srch_minmax(double mjd, double v, double *tmincp);
 static int srch_solve0(double mjd, double v, double *tmincp);
 static int srch_binary(double mjd, double v, double *tmincp);
+static int srch_findall(double mjd, double v, double *tmincp);
 
 void srch_setup()
 {
-    int srch_minmax(), srch_solve0(), srch_binary();
+    int srch_minmax(), srch_solve0(), srch_binary(), srch_findall();
     static char *chcs[] =
     {
-        "Find extreme", "Find 0", "Binary", "New function", "Accuracy",
-        "Stop"
+        "Find extreme", "Find 0", "Binary", "Find all", "New function",
+        "Accuracy", "Stop"
     };
     static int fn;	/* start with 0, then remember for next time */
+    int ch;
 
     /* let op select algorithm, edit, set accuracy
      * or stop if currently searching
      * algorithms require a function.
      */
 ask:
-    switch (popup(chcs, fn, srch_f ? 6 : 5))
+    ch = popup(chcs, fn, srch_f ? 7 : 6);
+    if (ch >= 0)
+        fa_stop ("stopped");	/* any choice ends a scan under way */
+    switch (ch)
     {
     case 0:
         fn = 0;
@@ -67,15 +98,25 @@ ask:
             goto ask;
     case 3:
         fn = 3;
+        if (expbuf[0] == '\0')
+            set_function();
+        srch_f = expbuf[0] && set_findall() == 0 ? srch_findall
+                 : (int (*)())0;
+        if (srch_f)
+            break;
+        else
+            goto ask;
+    case 4:
+        fn = 4;
         srch_f = 0;
         set_function();
         goto ask;
-    case 4:
-        fn = 4;
+    case 5:
+        fn = 5;
         srch_f = 0;
         set_accuracy();
         goto ask;
-    case 5:
+    case 6:
         srch_f = 0;
         srch_prstate(0);
         return;
@@ -111,6 +152,7 @@ double *tmincp;
         s = -1;
         srch_f = 0;
         f_msg (errbuf);
+        fa_stop ("function failed");
     }
     else
     {
@@ -129,7 +171,7 @@ double *tmincp;
 void srch_prstate (force)
 int force;
 {
-    int srch_minmax(), srch_solve0(), srch_binary();
+    int srch_minmax(), srch_solve0(), srch_binary(), srch_findall();
     static int (*last)();
 
     if (force || srch_f != last)
@@ -138,6 +180,7 @@ int force;
                   srch_f == srch_minmax   ? "Extrema" :
                   srch_f == srch_solve0   ? " Find 0" :
                   srch_f == srch_binary ?   " Binary" :
+                  srch_f == srch_findall ?  "FindAll" :
                   "    off");
         last = srch_f;
     }
@@ -192,6 +235,33 @@ void set_accuracy()
     }
 }
 
+/* ask for the window and event budget to use for the Find all search.
+ * RETURN keeps the current value of each.
+ * return 0 if ok, else -1 if op typed END.
+ */
+static
+int set_findall()
+{
+    char p[NC], buf[NC];
+    int n;
+
+    (void) sprintf (p, "Find all: days to scan <%g>: ", fa_window);
+    f_prompt (p);
+    if ((n = read_line (buf, PW-strlen(p))) < 0)
+        return (-1);
+    if (n > 0 && atof (buf) > 0)
+        fa_window = atof (buf);
+
+    (void) sprintf (p, "Find all: most events to collect <%d>: ", fa_budget);
+    f_prompt (p);
+    if ((n = read_line (buf, PW-strlen(p))) < 0)
+        return (-1);
+    if (n > 0 && atoi (buf) > 0)
+        fa_budget = atoi (buf);
+
+    return (0);
+}
+
 /* use successive paraboloidal fits to find when expression is at a
  * local minimum or maximum.
  */
@@ -432,3 +502,319 @@ double *tmincp;
         return (0);
     }
 }
+
+/* add an event to the Find all list, growing it as necessary.
+ * return 0 if ok, else -1 if no more memory.
+ */
+static
+int fa_add (t, v, kind)
+double t, v;
+int kind;
+{
+    if (fa_nevents == fa_mevents)
+    {
+        int n = fa_mevents ? 2*fa_mevents : 32;
+        SrchEvent *new;
+        if (n > fa_budget)
+            n = fa_budget;
+        new = (SrchEvent *) realloc ((char *)fa_events, n*sizeof(SrchEvent));
+        if (!new)
+            return (-1);
+        fa_events = new;
+        fa_mevents = n;
+    }
+    fa_events[fa_nevents].ev_mjd = t;
+    fa_events[fa_nevents].ev_val = v;
+    fa_events[fa_nevents].ev_kind = kind;
+    fa_nevents++;
+    return (0);
+}
+
+/* qsort compare function to put events in time order */
+static int
+fa_cmp (const void *e1, const void *e2)
+{
+    double d = ((SrchEvent *)e1)->ev_mjd - ((SrchEvent *)e2)->ev_mjd;
+    return (d < 0 ? -1 : d > 0 ? 1 : 0);
+}
+
+/* write all the events found by the Find all search to the listing file,
+ * in one block, with a heading line giving the function and window.
+ * if why is not 0 the scan ended early for that reason, and the heading says
+ * how far it got.
+ * N.B. an extreme may be refined after a later zero so sort them first.
+ */
+static
+void fa_report (why)
+char *why;
+{
+    static char *kinds[] = {"zero", "max ", "min "};
+#define	FA_LINELEN	64	/* longest line we produce, plus lots of slop */
+    char errbuf[NC];
+    char *text, *tp;
+    SrchEvent *ep;
+    double d;
+    int m, y, h, mn, s, neg;
+
+    fa_active = 0;
+    tp = text = malloc ((fa_nevents+2) * FA_LINELEN + sizeof(expbuf));
+    if (!text)
+    {
+        f_msg ("Find all: no memory for the report.");
+        return;
+    }
+    qsort ((char *)fa_events, fa_nevents, sizeof(SrchEvent), fa_cmp);
+
+    mjd_cal (fa_mjd0, &m, &d, &y);
+    if (why)
+        tp += sprintf (tp, "* Find all %s from %d/%02d/%d for %g of %g days, "
+                       "partial, %s: %d events\n", expbuf, m, (int)d, y,
+                       fa_upto - fa_mjd0, fa_end - fa_mjd0, why, fa_nevents);
+    else
+        tp += sprintf (tp, "* Find all %s from %d/%02d/%d for %g days: %d "
+                       "events\n", expbuf, m, (int)d, y, fa_end - fa_mjd0,
+                       fa_nevents);
+    for (ep = fa_events; ep < &fa_events[fa_nevents]; ep++)
+    {
+        mjd_cal (mjd_day (ep->ev_mjd), &m, &d, &y);
+        dec_sex (mjd_hr (ep->ev_mjd), &h, &mn, &s, &neg);
+        tp += sprintf (tp, "%2d/%02d/%-4d %2d:%02d:%02d  %s  %.12g\n",
+                       m, (int)d, y, h, mn, s, kinds[ep->ev_kind], ep->ev_val);
+    }
+
+    if (listing_text (text, errbuf) < 0)
+        f_msg (errbuf);
+    else
+    {
+        (void) sprintf (errbuf, "Find all%s%s: %d events written to listing "
+                        "file", why ? " " : "", why ? why : "", fa_nevents);
+        f_prompt (errbuf);
+    }
+    free (text);
+}
+
+/* if a Find all scan is under way, report what it has found so far as
+ * partial, for the reason why.
+ * called before anything else stops or restarts searching.
+ */
+static void
+fa_stop (why)
+char *why;
+{
+    if (fa_active)
+        fa_report (why);
+}
+
+/* scan forward from the starting time for fa_window days and collect every
+ * time the expression passes through 0 or reaches a local extreme, up to
+ * fa_budget events. the events are written to the listing file at the end.
+ * the scan step starts at StpSz and adapts between 1/8 and 8 times that:
+ * it halves when the function looks like it will reach 0 within two steps
+ * or is bending sharply, and doubles when it is far from 0 and nearly
+ * straight. once an event is bracketed it is refined to tmlimit, zeros with
+ * Illinois false-position and extremes with bracketed parabolic fits, then
+ * the scan resumes from where it left off.
+ */
+static
+int srch_findall(mjd, v, tmincp)
+double mjd;
+double v;
+double *tmincp;
+{
+#define	FA_SCAN		0	/* stepping forward looking for events */
+#define	FA_ZERO		1	/* refining a bracketed zero */
+#define	FA_EXTREME	2	/* refining a bracketed extreme */
+#define	FA_MAXITER	50	/* give up refining an event after this many */
+    static double h0, h;	/* initial and current scan step, days */
+    static double t[3], y[3];	/* last scan samples, oldest first */
+    static int ns;		/* number of t[] in use */
+    static int state;
+    static int niter;		/* refinement iterations so far */
+    static double za, zfa, zb, zfb; /* zero bracket; zb is newest */
+    static double ea, eb, ec;	/* extreme bracket, ea < eb < ec */
+    static double efa, efb, efc;
+    static int epending;	/* set when an extreme waits its turn */
+    double tol = tmlimit/24.0;	/* refinement accuracy, days */
+    double x;			/* next time we want, mjd */
+    int i;
+
+    if (srch_tmscalled == 0)
+    {
+        if (*tmincp <= 0.0)
+        {
+            f_msg ("Find all scans forward: StpSz must be positive.");
+            return (-1);
+        }
+        fa_mjd0 = fa_upto = mjd;
+        fa_end = mjd + fa_window;
+        fa_active = 1;
+        h0 = h = *tmincp/24.0;
+        t[0] = mjd;
+        y[0] = v;
+        ns = 1;
+        state = FA_SCAN;
+        epending = 0;
+        fa_nevents = 0;
+        return (0);
+    }
+
+    switch (state)
+    {
+    case FA_ZERO:
+        /* Illinois variant of false position */
+        if (v == 0.0 || ++niter > FA_MAXITER)
+            x = mjd;
+        else
+        {
+            if (v*zfb < 0.0)
+            {
+                za = zb;
+                zfa = zfb;
+            }
+            else
+                zfa /= 2.0;
+            zb = mjd;
+            zfb = v;
+            x = zb - zfb*(zb-za)/(zfb-zfa);
+        }
+        if (fabs (x - mjd) >= tol)
+        {
+            *tmincp = (x - mjd)*24.0;
+            return (0);
+        }
+        if (fa_add (mjd, v, EV_ZERO) < 0)
+            goto full;
+        break;
+
+    case FA_EXTREME:
+        /* mjd is a trial point within [ea,ec]: keep the best as eb */
+        if ((efb > efa) == (v > efb))
+        {
+            if (mjd < eb)
+            {
+                ec = eb;
+                efc = efb;
+            }
+            else
+            {
+                ea = eb;
+                efa = efb;
+            }
+            eb = mjd;
+            efb = v;
+        }
+        else if (mjd < eb)
+        {
+            ea = mjd;
+            efa = v;
+        }
+        else
+        {
+            ec = mjd;
+            efc = v;
+        }
+        if (ec - ea >= tol && ++niter <= FA_MAXITER)
+        {
+            /* vertex of parabola through the bracket, else bisect the
+             * larger side if that is not usefully inside.
+             */
+            double p = (eb-ea)*(efb-efc), q = (eb-ec)*(efb-efa);
+            x = (p != q) ? eb - ((eb-ea)*p - (eb-ec)*q)/(2.0*(p-q)) : eb;
+            if (!(x > ea && x < ec) || fabs (x - eb) < tol/2)
+                x = (eb-ea > ec-eb) ? (ea+eb)/2.0 : (eb+ec)/2.0;
+            *tmincp = (x - mjd)*24.0;
+            return (0);
+        }
+        if (fa_add (eb, efb, efb > efa ? EV_MAX : EV_MIN) < 0)
+            goto full;
+        epending = 0;
+        break;
+
+    default:
+        /* another scan sample */
+        if (ns == 3)
+        {
+            t[0] = t[1], y[0] = y[1];
+            t[1] = t[2], y[1] = y[2];
+            ns = 2;
+        }
+        t[ns] = mjd;
+        y[ns] = v;
+        i = ns++;
+        fa_upto = mjd;
+
+        if (ns == 3 && (y[1]-y[0])*(y[2]-y[1]) < 0.0)
+        {
+            ea = t[0], efa = y[0];
+            eb = t[1], efb = y[1];
+            ec = t[2], efc = y[2];
+            epending = 1;
+        }
+        if (v == 0.0)
+        {
+            if (fa_add (mjd, v, EV_ZERO) < 0)
+                goto full;
+        }
+        else if (y[i-1]*v < 0.0)
+        {
+            za = t[i-1], zfa = y[i-1];
+            zb = mjd, zfb = v;
+            niter = 0;
+            state = FA_ZERO;
+            x = zb - zfb*(zb-za)/(zfb-zfa);
+            *tmincp = (x - mjd)*24.0;
+            return (0);
+        }
+
+        /* adapt the step for next time */
+        {
+            double s1 = (y[i]-y[i-1])/(t[i]-t[i-1]);
+            if (fabs(v) < 2.0*fabs(s1)*h)
+                h /= 2.0;
+            else if (ns == 3)
+            {
+                double s0 = (y[1]-y[0])/(t[1]-t[0]);
+                double ds = fabs(s1-s0), sm = fmax (fabs(s0), fabs(s1));
+                if (ds > 0.5*sm)
+                    h /= 2.0;
+                else if (ds < 0.1*sm)
+                    h *= 2.0;
+            }
+            if (h < h0/8)
+                h = h0/8;
+            else if (h > h0*8)
+                h = h0*8;
+        }
+        break;
+    }
+
+    /* an event or a scan step is done. refine any extreme that was waiting
+     * behind a zero, else carry on scanning from the newest scan sample.
+     */
+    if (fa_nevents >= fa_budget)
+        goto full;
+    if (epending && state != FA_EXTREME)
+    {
+        niter = 0;
+        state = FA_EXTREME;
+        x = (eb-ea > ec-eb) ? (ea+eb)/2.0 : (eb+ec)/2.0;
+        *tmincp = (x - mjd)*24.0;
+        return (0);
+    }
+    state = FA_SCAN;
+    x = t[ns-1] + h;
+    if (x > fa_end)
+    {
+        if (t[ns-1] >= fa_end)
+            goto full;
+        x = fa_end;
+    }
+    *tmincp = (x - mjd)*24.0;
+    return (0);
+
+full:
+    /* window or budget exhausted: report and stop */
+    fa_report ((char *)0);
+    *tmincp = h0*24.0;
+    return (-1);
+}
@@ -0,0 +1,350 @@
+/* a catalog of fixed stars to draw behind the planets in the watch sky views.
+ * the catalog file has one star per line in the database fixed object form,
+ *   name,f,ra,dec,mag[,epoch]
+ * with ra as h:m:s, dec as d:m:s and epoch a decimal year, 2000 if absent.
+ * other lines are skipped, so ephem.db itself will serve.
+ * only stars at least as bright as the magnitude limit are kept. they are
+ * kept at 2000.0 as unit vectors in ST_NBANDS bands of declination, each
+ * sorted by ra. a frame then looks only at the part of each band within the
+ * hour angles where it can be up, so its cost follows the stars above the
+ * horizon, not the size of the catalog.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+#include "astro.h"
+#include "circum.h"
+#include "screen.h"
+#include "ephem.h"
+
+#define	ST_NBANDS	180	/* declination bands, one degree each */
+#define	ST_DEFMAG	5.0	/* default magnitude limit */
+
+typedef struct
+{
+    float s_ra;		/* ra at 2000.0, rads, 0..2*PI */
+    float s_mag;	/* visual magnitude */
+    float s_v[3];	/* equatorial unit vector at 2000.0 */
+    short s_band;	/* declination band, 0..ST_NBANDS-1 from the south */
+} Star;
+
+static char *st_file;		/* catalog file name, or 0 if none */
+static double st_maglim = ST_DEFMAG; /* faintest star to keep */
+static int st_tried;		/* !0 once loaded, or failed, for st_maglim */
+static double st_loadmag;	/* st_maglim when st_tried was set */
+static Star *stars;		/* the catalog, by band then ra */
+static int nstars;		/* entries in stars[] */
+static int band[ST_NBANDS+1];	/* band i is stars[band[i]..band[i+1]-1] */
+
+static int st_crack (char *buf, double j2000, Star *sp);
+static int st_cmp (const void *p1, const void *p2);
+static int st_first (int i0, int i1, double ra);
+static double st_halfday (double sphi, double cphi, double dec);
+
+/* set the catalog file name, as from STARS in the config file.
+ * an empty name means no stars.
+ */
+void stars_setfilename (name)
+char *name;
+{
+    if (st_file)
+        free (st_file);
+    st_file = 0;
+    if (*name)
+    {
+        st_file = malloc (strlen(name)+1);
+        if (st_file)
+            (void) strcpy (st_file, name);
+    }
+    st_tried = 0;
+}
+
+/* set the faintest magnitude to draw, as from STMAG in the config file */
+void stars_setmag (m)
+double m;
+{
+    st_maglim = m;
+}
+
+/* load the catalog, if there is one and it isn't already loaded for the
+ * current magnitude limit.
+ * return the number of stars kept. if the catalog could not all be read,
+ * the first time we try, say why in why[], else set why[0] to '\0'.
+ */
+int stars_load (why)
+char why[];
+{
+    char buf[128];
+    double j2000;
+    FILE *fp;
+    int n, nmax, i;
+
+    why[0] = '\0';
+    if (st_tried && st_loadmag == st_maglim)
+        return (nstars);
+    st_tried = 1;
+    st_loadmag = st_maglim;
+    nstars = 0;
+    for (i = 0; i <= ST_NBANDS; i++)
+        band[i] = 0;
+    if (!st_file)
+        return (0);
+
+    fp = fopen (st_file, "r");
+    if (!fp)
+    {
+        (void) sprintf (why, "Can not open star catalog %.90s", st_file);
+        return (0);
+    }
+
+    year_mjd (2000.0, &j2000);
+    n = nmax = 0;
+    while (fgets (buf, sizeof(buf), fp))
+    {
+        if (n == nmax)
+        {
+            Star *s;
+
+            nmax = nmax ? 2*nmax : 1024;
+            s = (Star *) realloc ((char *)stars, nmax*sizeof(Star));
+            if (!s)
+            {
+                (void) strcpy (why, "No memory for the whole star catalog.");
+                break;
+            }
+            stars = s;
+        }
+        if (st_crack (buf, j2000, &stars[n]) == 0
+                && stars[n].s_mag <= st_maglim)
+        {
+            band[stars[n].s_band+1]++;
+            n++;
+        }
+    }
+    (void) fclose (fp);
+
+    /* sort by band then ra, and sum the counts in band[] into each band's
+     * starting index.
+     */
+    qsort ((void *)stars, n, sizeof(Star), st_cmp);
+    for (i = 0; i < ST_NBANDS; i++)
+        band[i+1] += band[i];
+
+    nstars = n;
+    return (nstars);
+}
+
+/* call f with the altitude, azimuth and magnitude of each catalog star now
+ * above the horizon at np. alt and az are in rads, az east from north.
+ * no refraction, nutation or aberration; this is for drawing on a grid of
+ * characters.
+ */
+void stars_sky (np, f)
+Now *np;
+void (*f)(double alt, double az, double mag);
+{
+    double j2000, lst, sl, cl, sphi, cphi;
+    double p[3][3], a[3][3], m[3][3];
+    double zra, zsphi, zcphi;
+    char why[128];
+    int i, j, b;
+
+    if (stars_load (why) == 0)
+        return;
+
+    /* m takes a 2000.0 equatorial vector to (north, east, up) at np */
+    year_mjd (2000.0, &j2000);
+    precess_matrix (j2000, mjd, p);
+    now_lst (np, &lst);
+    lst = hrrad(lst);
+    sl = sin(lst);
+    cl = cos(lst);
+    sphi = sin(lat);
+    cphi = cos(lat);
+    a[0][0] = -sphi*cl;
+    a[0][1] = -sphi*sl;
+    a[0][2] = cphi;
+    a[1][0] = -sl;
+    a[1][1] = cl;
+    a[1][2] = 0.0;
+    a[2][0] = cphi*cl;
+    a[2][1] = cphi*sl;
+    a[2][2] = sphi;
+    for (i = 0; i < 3; i++)
+        for (j = 0; j < 3; j++)
+            m[i][j] = a[i][0]*p[0][j] + a[i][1]*p[1][j] + a[i][2]*p[2][j];
+
+    /* the zenith at 2000.0 gives the lst and latitude to cull with */
+    zra = atan2 (m[2][1], m[2][0]);
+    zsphi = m[2][2];
+    zcphi = sqrt (1.0 - zsphi*zsphi);
+
+    for (b = 0; b < ST_NBANDS; b++)
+    {
+        double d0 = degrad(b - 90.0), d1 = degrad(b + 1 - 90.0);
+        double h0, h1, h, lo, hi;
+        int seg[4];	/* up to two runs of stars[] to look at */
+        int ns;
+
+        if (band[b+1] == band[b])
+            continue;
+
+        /* half the ra span of the band that can be up; -1 if none */
+        h0 = st_halfday (zsphi, zcphi, d0);
+        h1 = st_halfday (zsphi, zcphi, d1);
+        h = h0 > h1 ? h0 : h1;
+        if (h < 0)
+            continue;
+
+        /* the stars with ra from lo to hi, wrapping through 0 if need be */
+        if (h >= PI)
+        {
+            seg[0] = band[b];
+            seg[1] = band[b+1];
+            ns = 2;
+        }
+        else
+        {
+            lo = zra - h;
+            range (&lo, 2*PI);
+            hi = lo + 2*h;
+            seg[0] = st_first (band[b], band[b+1], lo);
+            if (hi < 2*PI)
+            {
+                seg[1] = st_first (seg[0], band[b+1], hi);
+                ns = 2;
+            }
+            else
+            {
+                seg[1] = band[b+1];
+                seg[2] = band[b];
+                seg[3] = st_first (band[b], seg[0], hi - 2*PI);
+                ns = 4;
+            }
+        }
+
+        for (i = 0; i < ns; i += 2)
+            for (j = seg[i]; j < seg[i+1]; j++)
+            {
+                float *v = stars[j].s_v;
+                double x, y, z, az;
+
+                z = m[2][0]*v[0] + m[2][1]*v[1] + m[2][2]*v[2];
+                if (z <= 0.0)
+                    continue;
+                x = m[0][0]*v[0] + m[0][1]*v[1] + m[0][2]*v[2];
+                y = m[1][0]*v[0] + m[1][1]*v[1] + m[1][2]*v[2];
+                az = atan2 (y, x);
+                range (&az, 2*PI);
+                (*f) (asin (z > 1.0 ? 1.0 : z), az, (double)stars[j].s_mag);
+            }
+    }
+}
+
+/* crack one catalog line into *sp.
+ * return 0 if it is a star, else -1.
+ */
+static int
+st_crack (buf, j2000, sp)
+char *buf;
+double j2000;
+Star *sp;
+{
+    char *fld[6];
+    double ra, dec, ep;
+    int nf, h, m, s, b;
+    char *cp;
+
+    if (!isalpha(buf[0]))
+        return (-1);
+    for (nf = 0, cp = buf; nf < 6 && cp; nf++)
+    {
+        fld[nf] = cp;
+        if ((cp = strchr (cp, ',')))
+            *cp++ = '\0';
+    }
+    if (nf < 5 || fld[1][0] != 'f' || fld[1][1] != '\0')
+        return (-1);
+
+    h = m = s = 0;
+    f_sscansex (fld[2], &h, &m, &s);
+    sex_dec (h, m, s, &ra);
+    ra = hrrad(ra);
+    h = m = s = 0;
+    f_sscansex (fld[3], &h, &m, &s);
+    sex_dec (h, m, s, &dec);
+    dec = degrad(dec);
+    if (nf == 6)
+    {
+        year_mjd (atof (fld[5]), &ep);
+        if (ep != j2000)
+            precess (ep, j2000, &ra, &dec);
+    }
+    range (&ra, 2*PI);
+
+    sp->s_ra = ra;
+    sp->s_mag = atof (fld[4]);
+    sp->s_v[0] = cos(dec)*cos(ra);
+    sp->s_v[1] = cos(dec)*sin(ra);
+    sp->s_v[2] = sin(dec);
+    b = (int)floor(raddeg(dec) + 90.0);
+    sp->s_band = b < 0 ? 0 : b >= ST_NBANDS ? ST_NBANDS-1 : b;
+    return (0);
+}
+
+/* qsort compare: by band, then by ra */
+static int
+st_cmp (p1, p2)
+const void *p1, *p2;
+{
+    const Star *s1 = (const Star *)p1, *s2 = (const Star *)p2;
+
+    if (s1->s_band != s2->s_band)
+        return (s1->s_band - s2->s_band);
+    if (s1->s_ra != s2->s_ra)
+        return (s1->s_ra < s2->s_ra ? -1 : 1);
+    return (0);
+}
+
+/* return the index of the first star in stars[i0..i1-1] with s_ra >= ra,
+ * or i1 if there is none.
+ */
+static int
+st_first (i0, i1, ra)
+int i0, i1;
+double ra;
+{
+    int lo = i0, hi = i1;
+
+    while (lo < hi)
+    {
+        int mid = (lo + hi)/2;
+        if (stars[mid].s_ra < ra)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return (lo);
+}
+
+/* return the hour angle, rads, at which a star at declination dec sets for a
+ * latitude with sin sphi and cos cphi; PI if it never sets, -1 if it never
+ * rises.
+ */
+static double
+st_halfday (sphi, cphi, dec)
+double sphi, cphi, dec;
+{
+    double a = sphi*sin(dec), b = cphi*cos(dec);
+
+    if (b < 1e-12)
+        return (a > 0 ? PI : -1.0);
+    if (-a/b <= -1.0)
+        return (PI);
+    if (-a/b >= 1.0)
+        return (-1.0);
+    return (acos (-a/b));
+}
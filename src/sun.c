@@ -3,6 +3,10 @@
 #include "astro.h"
 #include "ephem.h"
 
+static double lastmjd = -10000;	/* mjd of lastlsn and lastrsn */
+static double lastlsn, lastrsn;
+static long ncalls, nevals;	/* for sunpos_counts() */
+
 /* given the modified JD, mjd, return the true geocentric ecliptic longitude
  *   of the sun for the mean equinox of the date, *lsn, in radians, and the
  *   sun-earth distance, *rsn, in AU. (the true ecliptic latitude is never more
@@ -10,6 +14,8 @@
  * if the APPARENT ecliptic longitude is required, correct the longitude for
  *   nutation to the true equinox of date and for aberration (light travel time,
  *   approximately  -9.27e7/186000/(3600*24*365)*2*pi = -9.93e-5 radians).
+ * the planets, the moon and the user objects all want the sun for the same
+ *   instant, so the last answer is kept and given again for the same mjd.
  */
 void sunpos (mjd, lsn, rsn)
 double mjd;
@@ -20,6 +26,15 @@ double *lsn, *rsn;
     double s, nu, ea; /* eccentricity, true anomaly, eccentric anomaly */
     double a, b, a1, b1, c1, d1, e1, h1, dl, dr;
 
+    ncalls++;
+    if (mjd == lastmjd)
+    {
+        *lsn = lastlsn;
+        *rsn = lastrsn;
+        return;
+    }
+    nevals++;
+
     t = mjd/36525.;
     t2 = t*t;
     a = 100.0021359*t;
@@ -53,4 +68,18 @@ double *lsn, *rsn;
     *lsn = nu+degrad(ls-ms+dl);
     *rsn = 1.0000002*(1-s*cos(ea))+dr;
     range (lsn, 2*PI);
+
+    lastmjd = mjd;
+    lastlsn = *lsn;
+    lastrsn = *rsn;
+}
+
+/* report the number of calls to sunpos() so far, and how many of them had
+ * to work it out rather than give the last answer again.
+ */
+void sunpos_counts (calls, evals)
+long *calls, *evals;
+{
+    *calls = ncalls;
+    *evals = nevals;
 }
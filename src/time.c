@@ -22,13 +22,14 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 #include <time.h>
 
 #include "astro.h"
 #include "circum.h"
 #include "ephem.h"
 
-static long c0;
+static double t0;	/* time_mono() when mjd was mjd0 */
 static double mjd0;
 
 static void settzstuff (int dst, Now *np);
@@ -40,7 +41,33 @@ void set_t0 (np)
 Now *np;
 {
     mjd0 = mjd;
-    (void) time (&c0);
+    t0 = time_mono();
+}
+
+/* return seconds, to sub-second resolution, from a clock that only ever
+ * runs steadily forward, if we have one, else from the real-time clock.
+ */
+double time_mono()
+{
+#ifdef CLOCK_MONOTONIC
+    struct timespec ts;
+
+    if (clock_gettime (CLOCK_MONOTONIC, &ts) == 0)
+        return (ts.tv_sec + ts.tv_nsec*1e-9);
+#endif
+    return (time_real());
+}
+
+/* return seconds since the epoch, to sub-second resolution if we can. */
+double time_real()
+{
+#ifdef CLOCK_REALTIME
+    struct timespec ts;
+
+    if (clock_gettime (CLOCK_REALTIME, &ts) == 0)
+        return (ts.tv_sec + ts.tv_nsec*1e-9);
+#endif
+    return ((double) time ((time_t *)0));
 }
 
 /* fill in n_mjd/tz/tznm from system clock.
@@ -51,15 +78,29 @@ Now *np;
     struct tm *tp;
     time_t c;
     double day, hr;
+    double frac;	/* fraction of a second past c */
+
+#ifdef CLOCK_REALTIME
+    struct timespec ts;
 
-    (void) time (&c);
+    if (clock_gettime (CLOCK_REALTIME, &ts) == 0)
+    {
+        c = ts.tv_sec;
+        frac = ts.tv_nsec*1e-9;
+    }
+    else
+#endif
+    {
+        (void) time (&c);
+        frac = 0.0;
+    }
 
     tp = gmtime (&c);
     if (tp)
     {
         cal_mjd (tp->tm_mon+1, (double)tp->tm_mday, tp->tm_year+1900, &day);
         sex_dec (tp->tm_hour, tp->tm_min, tp->tm_sec, &hr);
-        mjd = day + hr/24.0;
+        mjd = day + (hr + frac/3600.0)/24.0;
         tp = localtime (&c);
         settzstuff (tp->tm_isdst ? 1 : 0, np);
     }
@@ -73,7 +114,7 @@ Now *np;
         tp = localtime (&c);
         cal_mjd (tp->tm_mon+1, (double)tp->tm_mday, tp->tm_year+1900, &day);
         sex_dec (tp->tm_hour, tp->tm_min, tp->tm_sec, &hr);
-        mjd = day + hr/24.0 + tz/24.0;
+        mjd = day + (hr + frac/3600.0)/24.0 + tz/24.0;
     }
 }
 
@@ -116,16 +157,20 @@ double inc;
 {
     if (inc == RTC)
     {
-        long c;
-        (void) time (&c);
-        mjd = mjd0 + (c - c0)/SPD;
+        /* keep the fraction of a second so the display tracks the clock,
+         * but round to the nearest millisecond for the reason below.
+         */
+        mjd = mjd0 + (time_mono() - t0)/SPD;
+        mjd = floor (mjd*SPD*1000.0 + 0.5)/(SPD*1000.0);
     }
     else
+    {
         mjd += inc/24.0;
 
-    /* round to nearest whole second.
-     * without this, you can get fractional days so close to .5 but
-     * not quite there that mjd_hr() can return 24.0
-     */
-    rnd_second (&mjd);
+        /* round to nearest whole second.
+         * without this, you can get fractional days so close to .5 but
+         * not quite there that mjd_hr() can return 24.0
+         */
+        rnd_second (&mjd);
+    }
 }
@@ -4,9 +4,103 @@
 #include "screen.h"
 #include "ephem.h"
 
-static char vmsg[] = "Version 4.32 December 10, 2021";
+static char vmsg[] = "Version 4.33 October 19, 2026";
 
 /*
+ * 4.33 10/19/26 srch.c listing.c ephem.h
+ *              - "Find all" search collects every zero and extreme in a
+ *                window with an adaptive scan step and an event budget,
+ *                then appends them all to the listing file.
+ *              binio.c binio.h plot.c listing.c main.c Makefile
+ *              - plot and listing files may also be written as packed
+ *                little-endian binary records, optionally gzip framed
+ *                with -DUSE_ZLIB; the plot and listing viewers read either.
+ *              plot.c binio.c binio.h
+ *              - plot viewer maps the file, bins points per screen cell and
+ *                pages and zooms through it, with memory independent of
+ *                the file size.
+ *              listing.c
+ *              - listing viewer pages both ways, pans, jumps to a row and
+ *                finds text through a fixed size index of line offsets.
+ *              flog.c plot.c listing.c
+ *              - no fixed limit on logged fields, plot lines or listing
+ *                columns; flogs are found through a direct field index.
+ *              time.c io.c main.c ephem.h
+ *              - real-time clock mode keeps time to the millisecond from
+ *                clock_gettime(); StPause waits in one poll() on the
+ *                keyboard to a fixed deadline rather than once a second.
+ *              io.c main.c watch.c ephem.h
+ *              - chk_char() relies on SIGIO to know when to look for
+ *                input, so free running makes no system calls to poll
+ *                the keyboard; SIGWINCH is handled between steps.
+ *              phoon.c watch.c main.c ephem.h
+ *              - moon watch keeps the last few rendered moons by phase and
+ *                only repaints the moon when its picture changes.
+ *              moonnf.c mainmenu.c phoonastro.c ephem.h
+ *              - phases of the moon may be walked one quarter at a time
+ *                from any date or listed over a span; the calendar and
+ *                moon watch use this rather than hunting from scratch.
+ *              yearcal.c circum.c main.c sel_fld.c ephem.h
+ *              - picking the calendar heading writes a whole year's
+ *                calendar, with twilight and moon phases, as text or CSV.
+ *              altj.c main.c sel_fld.c screen.h ephem.h
+ *              - jupmoons() finds the Galilean moons at many dates at once;
+ *                Moon events on the Jupiter menu lists their transits,
+ *                occultations, shadow transits and eclipses.
+ *              pelement.c plans.c ephem.h
+ *              - plans() finds the mean elements of only the planets it
+ *                needs; sweeps at a constant step update them by forward
+ *                differences rather than evaluating each cubic afresh.
+ *              plans.c
+ *              - the outer planet perturbations take their many harmonics
+ *                from a few sines and cosines by angle addition, and are
+ *                found once rather than again on the light-time pass.
+ *              moon.c ephem.h
+ *              - the moon's series are tables of terms evaluated from the
+ *                sines and cosines of a few multiples of each argument;
+ *                moon_n() finds the moon at many dates.
+ *              watch.c io.c formats.c main.c ephem.h
+ *              - -F n with -W 1-3 draws n frames of the watch view offscreen,
+ *                in parallel, and writes them as text or an asciicast.
+ *              objx.c reduce.c
+ *              - obj_cir() keeps each object's elements reduced to the
+ *                nearest whole day and reuses them; reduce_elements() no
+ *                longer gives nan when asked for the elements' own epoch.
+ *              objx.c precess.c eq_ecl.c ephem.h
+ *              - fixed objects are kept as unit vectors and moved to the
+ *                ecliptic of date by one matrix, made once per date with
+ *                the new precess_matrix() and eq_ecl_matrix().
+ *              stars.c watch.c main.c ephem.h
+ *              - the sky views draw the stars of an optional catalog, set by
+ *                STARS and STMAG, kept in declination bands sorted by ra so
+ *                only those that can be up are looked at.
+ *              objx.c
+ *              - the database file is read once, in parallel, and saved
+ *                beside it as <name>.bin to be mapped in by later runs.
+ *              objx.c
+ *              - the saved database is sorted by name too; lookups by name
+ *                are binary searches, and "/" in the Lookup screen narrows
+ *                the list as a name is typed.
+ *              eq_ecl.c aa_hadec.c precess.c ephem.h
+ *              - eq_ecl_n(), ecl_eq_n(), aa_hadec_n(), hadec_aa_n() and
+ *                precess_n() convert arrays of positions, with the set up
+ *                done once; the one-at-a-time forms now call them.
+ *              astro.h
+ *              - degrad() and the other unit conversions are each one
+ *                multiply by a constant factor, DEGRAD, RADDEG, HRRAD or
+ *                RADHR.
+ *              riset_c.c circum.h yearcal.c ephem.h
+ *              - twilight_table() finds astronomical, nautical and civil
+ *                twilight for many days from one sun position a day; the
+ *                year calendar uses it and its CSV adds nautical and civil.
+ *              sun.c ephem.h
+ *              - sunpos() gives its last answer again for the same mjd, and
+ *                sunpos_counts() tells how often it had to work one out.
+ *              prof.c ephem.h main.c circum.c plans.c moon.c riset_c.c
+ *                compiler.c flog.c formats.c io.c plot.c listing.c Makefile
+ *              - with -DPROFILE, counts and times of the main computations
+ *                and of screen and file output go to ephem.prof on exit
+ *                and on SIGUSR1.
  * 4.32 12/10/21 globe.c watch.c sel_fld.c plot.c main.c tags formats.c ephem.h listing.c io.c
  *            lint to run on macOS; no changes in functionality
  * 4.31 12/14/15 screen.h main.c sel_fld.c version.c watch.c mods
@@ -10,7 +10,14 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
 #include "astro.h"
 #include "circum.h"
 #include "screen.h"
@@ -34,6 +41,15 @@ int watching;			/* are we in a watch mode ? */
 #include <time.h>
 #endif
 
+#ifndef MAP_ANON
+#define	MAP_ANON	MAP_ANONYMOUS
+#endif
+
+#define	WF_DELAY	0.1	/* seconds between asciicast frames */
+#define	WF_MAXPROCS	16	/* most processes drawing offscreen frames */
+
+#define	ST_BRIGHT	1.5	/* stars this bright are '*', fainter ones '.' */
+
 #define	SKYACC	3600.	/* desired sky plot accuracy, in arc seconds */
 #define	SSACC	3600.	/* desired solar system plot accuracy, in arc secs */
 
@@ -63,9 +79,31 @@ typedef struct
 } LastDraw;
 
 static int trails;	/* !0 if want to leave trails */
+static double wacc = 1.0; /* scales SKYACC and SSACC; 0 for exact frames */
+
+/* the catalog stars on the sky views, as the char in each screen cell,
+ * row by row, or 0 where there is none. st_shown is what is on the screen,
+ * st_want what the current frame should have.
+ */
+static char *st_shown, *st_want;
+static int st_ncells;	/* NR*NC when they were made */
+static int st_style;	/* DOME_SKY or ALTAZ_SKY, for st_plot() */
 
 void watch_sky (int style, Now *np, double tminc, int wbodies);
 static void watch_solarsystem (Now *np, double tminc, int wbodies);
+static double ss_scale (int wbodies);
+static void ss_labels (Now *np);
+static void ss_update (Now *np, int wbodies, double scale, LastDraw ld0[],
+                       LastDraw ld1[], LastDraw **newp, LastDraw **lastp,
+                       int *nlast);
+static void wf_draw (int nf, Now *np, int wbodies, char *buf);
+static void wf_share (int w, int nw, int nf, Now *np, double tminc,
+                      int wbodies, int nframes, char *frames);
+static void wf_utc (double jd, char buf[]);
+static void wf_json (FILE *fp, char *s, int n);
+static void st_draw (Now *np, int style);
+static void st_plot (double alt, double az, double mag);
+static int st_free (int r, int c);
 static void set_ss (LastDraw *lp, double dist, double lg, double lt, int tag);
 static void set_screencoords (LastDraw lp[], int np);
 static void safe_f_char (int r, int c, int tag);
@@ -259,6 +297,10 @@ Now *np;	/* time now and on each step */
     f_string (3, 1, "LST");
 
     COLOR_OFF;
+
+    /* the screen is clear, so no stars are showing */
+    if (st_shown)
+        (void) memset (st_shown, 0, st_ncells);
 }
 
 
@@ -282,7 +324,7 @@ int *nlast;
     for (p = nxtbody(-1); p != -1; p = nxtbody(p))
         if (wbodies & (1<<p))
         {
-            (void) body_cir (p, SKYACC, np, s);
+            (void) body_cir (p, SKYACC*wacc, np, s);
             if ((*s).s_alt > 0.0)
             {
                 LastDraw *lnp = (*newp) + nnew;
@@ -308,7 +350,14 @@ int *nlast;
      */
     if (!trails)
         for (lp = (*lastp); --(*nlast) >= 0; lp++)
+        {
             f_char (lp->l_r, lp->l_c, ' ');
+            if (st_shown)
+                st_shown[(lp->l_r-1)*NC + lp->l_c-1] = 0;
+        }
+
+    /* move the stars, under where the bodies will go */
+    st_draw (np, style);
 
     /* print LOCAL time and date we will be using */
     lmjd = mjd - tz/24.0;
@@ -373,7 +422,7 @@ int wbodies;	/* each bit is !=0 if want */
         if (!once)
             slp_sync();
 
-        if (once || (chk_char()==0 && read_char()!=0))
+        if (once || (chk_event()==0 && read_char()!=0))
         {
             if (readwcmd (tminc0, &tminc, &once) < 0)
                 break;
@@ -388,111 +437,146 @@ int wbodies;	/* each bit is !=0 if want */
 }
 
 
-/* solar system view, "down from the top", first point of aries to the right.
- * always include earth.
+/* set screen scale for the solar system view: largest au we will have to
+ * plot. never make it less than 1 au (with fudge) since we always show earth.
  */
-static
-void watch_solarsystem (np, tminc, wbodies)
-Now *np;	/* time now and on each step */
-double tminc;	/* hrs to increment time by each step */
+static double
+ss_scale (wbodies)
 int wbodies;
 {
     /* max au of each planet from sun; in astro.h #defines order */
     static double auscale[] = {.38, .75, 1.7, 5.2, 11., 20., 31., 50.};
-    double tminc0 = tminc;	/* remember the original */
-    /* two draw buffers so we can leave old up while calc new then
-     * erase and draw in one quick operation. always calc new in newp
-     * buffer and erase previous from lastp. buffers alternate roles.
-     */
-    LastDraw ld0[2*NOBJ], ld1[2*NOBJ], *lp, *lastp = ld0, *newp = ld1;
-    int nlast = 0, nnew;
-    int once = 1;
-    double lmjd;
     double scale;
-    Sky s;
     int p;
-    Last_np = np;
 
-    /* set screen scale: largest au we will have to plot.
-     * never make it less than 1 au (with fudge) since we always show earth.
-     */
     scale = 1.1;
     for (p = MARS; p <= PLUTO; p++)
         if ((wbodies & (1<<p)) && auscale[p] > scale)
             scale = auscale[p];
+    return (scale);
+}
 
-    /* clear screen and put up the permanent labels */
+/* clear screen and put up the permanent solar system labels */
+static void
+ss_labels (np)
+Now *np;
+{
     c_erase();
     COLOR_CODE(COLOR_WATCH);
     f_string (2, 1, tznm);
     COLOR_OFF;
+}
 
-    while (1)
-    {
-        if (once)
-            print_updating();
+/* draw the solar system at np, erasing the last one unless want trails */
+static void
+ss_update (np, wbodies, scale, ld0, ld1, newp, lastp, nlast)
+Now *np;	/* time now and on each step */
+int wbodies;	/* each bit is !=0 if want */
+double scale;	/* from ss_scale() */
+LastDraw ld0[2*NOBJ], ld1[2*NOBJ];
+LastDraw **newp, **lastp;
+int *nlast;
+{
+    LastDraw *lp;
+    double lmjd;
+    int nnew;
+    Sky s;
+    int p;
 
-        /* calculate desired stuff into newp[].
-         * fake a sun at center and add earth first.
-         * (we get earth's loc when ask for sun)
-         */
-        nnew = 0;
-        set_ss (newp+nnew, 0.0, 0.0, 0.0, 'S');
-        nnew += 2;
-        (void) body_cir (SUN, SSACC, np, &s);
-        set_ss (newp+nnew, s.s_edist/scale, s.s_hlong, 0.0, 'E');
-        nnew += 2;
-        for (p = MERCURY; p <= PLUTO; p++)
-            if (p != MOON && (wbodies & (1<<p)))
+    /* calculate desired stuff into newp[].
+     * fake a sun at center and add earth first.
+     * (we get earth's loc when ask for sun)
+     */
+    nnew = 0;
+    set_ss ((*newp)+nnew, 0.0, 0.0, 0.0, 'S');
+    nnew += 2;
+    (void) body_cir (SUN, SSACC*wacc, np, &s);
+    set_ss ((*newp)+nnew, s.s_edist/scale, s.s_hlong, 0.0, 'E');
+    nnew += 2;
+    for (p = MERCURY; p <= PLUTO; p++)
+        if (p != MOON && (wbodies & (1<<p)))
+        {
+            (void) body_cir (p, SSACC*wacc, np, &s);
+            set_ss ((*newp)+nnew, s.s_sdist/scale, s.s_hlong, s.s_hlat,
+                    body_tags[p]);
+            nnew += 2;
+        }
+    for (p = OBJX; p != -1; p = (p == OBJX) ? OBJY : -1)
+        if (wbodies & (1<<p))
+        {
+            (void) body_cir (p, SSACC*wacc, np, &s);
+            if (s.s_hlong != NOHELIO && s.s_sdist <= scale)
             {
-                (void) body_cir (p, SSACC, np, &s);
-                set_ss (newp+nnew, s.s_sdist/scale, s.s_hlong, s.s_hlat,
+                set_ss ((*newp)+nnew, s.s_sdist/scale, s.s_hlong, s.s_hlat,
                         body_tags[p]);
                 nnew += 2;
             }
-        for (p = OBJX; p != -1; p = (p == OBJX) ? OBJY : -1)
-            if (wbodies & (1<<p))
-            {
-                (void) body_cir (p, SSACC, np, &s);
-                if (s.s_hlong != NOHELIO && s.s_sdist <= scale)
-                {
-                    set_ss (newp+nnew, s.s_sdist/scale, s.s_hlong, s.s_hlat,
-                            body_tags[p]);
-                    nnew += 2;
-                }
-            }
+        }
 
-        set_screencoords (newp, nnew);
+    set_screencoords ((*newp), nnew);
 
-        /* unless we want trails,
-         * erase any previous tags (in same order as written) from lastp[].
-         */
-        if (!trails)
-            for (lp = lastp; --nlast >= 0; lp++)
-                safe_f_char (lp->l_r, lp->l_c, ' ');
+    /* unless we want trails,
+     * erase any previous tags (in same order as written) from lastp[].
+     */
+    if (!trails)
+        for (lp = (*lastp); --(*nlast) >= 0; lp++)
+            safe_f_char (lp->l_r, lp->l_c, ' ');
 
-        /* print LOCAL time and date we will be using */
-        lmjd = mjd - tz/24.0;
-        f_time (2, 5, mjd_hr(lmjd));
-        f_date (2, 14, mjd_day(lmjd));
+    /* print LOCAL time and date we will be using */
+    lmjd = mjd - tz/24.0;
+    f_time (2, 5, mjd_hr(lmjd));
+    f_date (2, 14, mjd_day(lmjd));
 
-        /* now draw new stuff from newp[] and park the cursor */
-        for (lp = newp; lp < newp + nnew; lp++)
-            safe_f_char (lp->l_r, lp->l_c, lp->l_tag);
-        c_pos (PARK_ROW, PARK_COL);
-        fflush (stdout);
+    /* now draw new stuff from newp[] and park the cursor */
+    for (lp = (*newp); lp < (*newp) + nnew; lp++)
+        safe_f_char (lp->l_r, lp->l_c, lp->l_tag);
+    c_pos (PARK_ROW, PARK_COL);
+    fflush (stdout);
 
-        /* swap new and last roles and save new count */
-        if (newp == ld0)
-            newp = ld1, lastp = ld0;
-        else
-            newp = ld0, lastp = ld1;
-        nlast = nnew;
+    /* swap new and last roles and save new count */
+    if ((*newp) == ld0)
+        (*newp) = ld1, (*lastp) = ld0;
+    else
+        (*newp) = ld0, (*lastp) = ld1;
+    *nlast = nnew;
+}
+
+/* solar system view, "down from the top", first point of aries to the right.
+ * always include earth.
+ */
+static
+void watch_solarsystem (np, tminc, wbodies)
+Now *np;	/* time now and on each step */
+double tminc;	/* hrs to increment time by each step */
+int wbodies;
+{
+    double tminc0 = tminc;	/* remember the original */
+    /* two draw buffers so we can leave old up while calc new then
+     * erase and draw in one quick operation. always calc new in newp
+     * buffer and erase previous from lastp. buffers alternate roles.
+     */
+    LastDraw ld0[2*NOBJ], ld1[2*NOBJ], *lastp = ld0, *newp = ld1;
+    int nlast = 0;
+    int once = 1;
+    double scale;
+    Last_np = np;
+
+    scale = ss_scale (wbodies);
+
+    /* clear screen and put up the permanent labels */
+    ss_labels (np);
+
+    while (1)
+    {
+        if (once)
+            print_updating();
+
+        ss_update (np, wbodies, scale, ld0, ld1, &newp, &lastp, &nlast);
 
         if (!once)
             slp_sync();
 
-        if (once || (chk_char()==0 && read_char()!=0))
+        if (once || (chk_event()==0 && read_char()!=0))
         {
             if (readwcmd (tminc0, &tminc, &once) < 0)
                 break;
@@ -504,6 +588,105 @@ int wbodies;
     }
 }
 
+/* bring the stars on the screen up to date for np: draw the ones now in
+ * cells without one and, unless leaving trails, blank those that have left.
+ * nothing to do if there is no star catalog.
+ */
+static void
+st_draw (np, style)
+Now *np;
+int style;
+{
+    char why[128];
+    int i, n = NR*NC;
+    int nst = stars_load (why);
+
+    if (why[0])
+        f_msg (why);
+    if (nst == 0)
+        return;
+    if (n != st_ncells)
+    {
+        char *s = realloc (st_shown, n);
+        char *w = s ? realloc (st_want, n) : 0;
+
+        if (s)
+            st_shown = s;
+        if (w)
+            st_want = w;
+        if (!s || !w)
+            return;
+        /* made just after sky_dome_labels() cleared the screen */
+        (void) memset (st_shown, 0, n);
+        st_ncells = n;
+    }
+
+    (void) memset (st_want, 0, n);
+    st_style = style;
+    stars_sky (np, st_plot);
+
+    for (i = 0; i < n; i++)
+        if (st_want[i] != st_shown[i])
+        {
+            if (st_want[i])
+                f_char (i/NC + 1, i%NC + 1, st_want[i]);
+            else if (!trails)
+                f_char (i/NC + 1, i%NC + 1, ' ');
+            else
+                continue;
+            st_shown[i] = st_want[i];
+        }
+}
+
+/* stars_sky() calls this with each star that is up. mark its cell in
+ * st_want[], the same place a body would go, keeping '*' over '.'.
+ */
+static void
+st_plot (alt, az, mag)
+double alt, az, mag;
+{
+    double fr, fc;
+    int r, c;
+    char *cp;
+
+    if (st_style == DOME_SKY)
+    {
+        double tmp = 0.5 - alt/PI;
+        fr = 0.5 - tmp*cos(az);
+        fc = 0.5 - tmp*sin(az)/ASPECT;
+    }
+    else
+    {
+        fr = 1.0 - alt/(PI/2);
+        fc = az/(2*PI);
+    }
+    r = fr2r(fr);
+    c = fc2c(fc);
+    if (!st_free (r, c))
+        return;
+    cp = &st_want[(r-1)*NC + c-1];
+    if (mag <= ST_BRIGHT)
+        *cp = '*';
+    else if (!*cp)
+        *cp = '.';
+}
+
+/* return !0 if a star may be drawn at row r, col c; ie, it is on the screen
+ * and clear of the prompt line, the time and compass labels.
+ */
+static int
+st_free (r, c)
+int r, c;
+{
+    if (r <= 1 || r >= NR || c < 1 || c > NC)
+        return (0);
+    if (r <= 3 && c <= 24)
+        return (0);
+    if (r == 2 && c >= NC/2-4 && c <= NC/2+4)
+        return (0);
+    return (1);
+}
+
 /* fill in two LastDraw solar system entries,
  * one for the x/y display, one for the z.
  */
@@ -632,9 +815,294 @@ int *once;
 }
 
 
+/* draw nframes of watch view nf offscreen, the first at np and each one
+ * tminc hours after the one before, and write them to the file fn, or to
+ * stdout if fn is 0. a name ending in .cast gets an asciicast (version 2)
+ * for playing back elsewhere; anything else gets plain text, each frame
+ * after a line giving its number and UTC.
+ * each frame depends only on its time so they are shared out among child
+ * processes, one per processor, which draw straight into a shared map.
+ * return 0 if ok, else -1 with a reason in why[].
+ */
+int
+watch_frames (nf, np, tminc, wbodies, nframes, fn, why)
+int nf;		/* WATCH_DOME, WATCH_ALTAZ or WATCH_SOLAR_SYS */
+Now *np;	/* time of the first frame */
+double tminc;	/* hrs from one frame to the next */
+int wbodies;	/* each bit is !=0 if want that body */
+int nframes;	/* number of frames to draw */
+char *fn;	/* file to write, or 0 for stdout */
+char why[];	/* reason for failing */
+{
+    pid_t pids[WF_MAXPROCS];
+    size_t fsz = (size_t)NR*NC;
+    char *frames;
+    int mapped;
+    int nw, w, i, r;
+    int cast;
+    FILE *fp;
+    long ncpu;
+
+    if (nf != WATCH_DOME && nf != WATCH_ALTAZ && nf != WATCH_SOLAR_SYS)
+    {
+        (void) strcpy (why,
+            "Only the sky dome, alt/az and solar system views can be saved.");
+        return (-1);
+    }
+    if (tminc == RTC)
+    {
+        (void) strcpy (why, "StpSz must be a fixed step to save frames.");
+        return (-1);
+    }
+    if (nframes < 1)
+    {
+        (void) strcpy (why, "Need at least one frame.");
+        return (-1);
+    }
+
+    /* any star catalog is read now, once, rather than in each child */
+    (void) stars_load (why);
+    if (why[0])
+        return (-1);
+
+    /* one map for all the frames, shared with the children if we can */
+    frames = mmap ((void *)0, nframes*fsz, PROT_READ|PROT_WRITE,
+                   MAP_SHARED|MAP_ANON, -1, (off_t)0);
+    mapped = frames != MAP_FAILED;
+    if (!mapped)
+    {
+        frames = malloc (nframes*fsz);
+        if (!frames)
+        {
+            (void) sprintf (why, "No memory for %d frames.", nframes);
+            return (-1);
+        }
+    }
+
+    /* share out the frames, keeping the first share for ourselves.
+     * if a child can not be made, we draw its share too.
+     */
+    ncpu = sysconf (_SC_NPROCESSORS_ONLN);
+    nw = mapped && ncpu > 1 ? (int)ncpu : 1;
+    if (nw > WF_MAXPROCS)
+        nw = WF_MAXPROCS;
+    if (nw > nframes)
+        nw = nframes;
+    (void) fflush (stdout);
+    for (w = 1; w < nw; w++)
+    {
+        pids[w] = fork();
+        if (pids[w] == 0)
+        {
+            wf_share (w, nw, nf, np, tminc, wbodies, nframes, frames);
+            _exit (0);
+        }
+    }
+    wf_share (0, nw, nf, np, tminc, wbodies, nframes, frames);
+    r = 0;
+    for (w = 1; w < nw; w++)
+    {
+        int status;
+
+        if (pids[w] < 0)
+            wf_share (w, nw, nf, np, tminc, wbodies, nframes, frames);
+        else if (waitpid (pids[w], &status, 0) != pids[w]
+                 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            r = -1;
+    }
+    if (r < 0)
+    {
+        (void) strcpy (why, "A process drawing frames failed.");
+        goto out;
+    }
+
+    if (fn)
+    {
+        fp = fopen (fn, "w");
+        if (!fp)
+        {
+            (void) sprintf (why, "can't open %.80s: %s", fn, strerror(errno));
+            r = -1;
+            goto out;
+        }
+    }
+    else
+        fp = stdout;
+    i = fn ? strlen(fn) : 0;
+    cast = i > 5 && strcmp (fn+i-5, ".cast") == 0;
+
+    if (cast)
+        (void) fprintf (fp,
+                "{\"version\": 2, \"width\": %d, \"height\": %d}\n", NC, NR);
+    for (i = 0; i < nframes; i++)
+    {
+        char *f = frames + i*fsz;
+        char utc[64];
+        int row;
+
+        if (cast)
+        {
+            (void) fprintf (fp, "[%.3f, \"o\", \"", i*WF_DELAY);
+            wf_json (fp, "\033[H\033[2J", 7);
+        }
+        else
+        {
+            wf_utc (np->n_mjd + i*tminc/24.0, utc);
+            (void) fprintf (fp, "frame %d %s\n", i+1, utc);
+        }
+        for (row = 0; row < NR; row++)
+        {
+            char *lp = f + row*NC;
+            int n;
+
+            for (n = NC; n > 0 && lp[n-1] == ' '; --n)
+                continue;
+            if (cast)
+            {
+                wf_json (fp, lp, n);
+                if (row < NR-1)
+                    wf_json (fp, "\r\n", 2);
+            }
+            else
+            {
+                (void) fwrite (lp, 1, n, fp);
+                (void) putc ('\n', fp);
+            }
+        }
+        if (cast)
+            (void) fprintf (fp, "\"]\n");
+    }
+
+    if (ferror (fp))
+    {
+        (void) sprintf (why, "error writing %.80s: %s", fn ? fn : "frames",
+                        strerror(errno));
+        r = -1;
+    }
+    if (fp != stdout)
+        (void) fclose (fp);
+    else
+        (void) fflush (fp);
+
+out:
+    if (mapped)
+        (void) munmap (frames, nframes*fsz);
+    else
+        free (frames);
+    return (r);
+}
+
+/* draw view nf at np into buf, from scratch */
+static void
+wf_draw (nf, np, wbodies, buf)
+int nf;
+Now *np;
+int wbodies;
+char *buf;
+{
+    LastDraw ld0[2*NOBJ], ld1[2*NOBJ], *lastp = ld0, *newp = ld1;
+    int nlast = 0;
+    double tmp;
+    Sky s;
+
+    c_offscreen (buf);
+    if (nf == WATCH_SOLAR_SYS)
+    {
+        ss_labels (np);
+        ss_update (np, wbodies, ss_scale (wbodies), ld0, ld1, &newp, &lastp,
+                   &nlast);
+    }
+    else
+    {
+        int style = nf == WATCH_DOME ? DOME_SKY : ALTAZ_SKY;
+
+        sky_dome_labels (style, np);
+        sky_dome_update (style, np, wbodies, ld0, ld1, &newp, &lastp, &s,
+                         &tmp, &nlast);
+    }
+    c_offscreen ((char *)0);
+}
+
+/* draw share w of nw of the frames for watch_frames(): every nw'th frame,
+ * starting with frame w, so each share has much the same amount of sky.
+ */
+static void
+wf_share (w, nw, nf, np, tminc, wbodies, nframes, frames)
+int w, nw;
+int nf;
+Now *np;
+double tminc;
+int wbodies;
+int nframes;
+char *frames;
+{
+    Now now;
+    int i;
+
+#ifdef ANSI_COLORS
+    Colors_Enabled = 0;
+#endif
+    /* compute each frame afresh, so it does not depend on which frames
+     * came before it in this share.
+     */
+    wacc = 0.0;
+    now = *np;
+    for (i = w; i < nframes; i += nw)
+    {
+        now.n_mjd = np->n_mjd + i*tminc/24.0;
+        rnd_second (&now.n_mjd);
+        wf_draw (nf, &now, wbodies, frames + (size_t)i*NR*NC);
+    }
+    wacc = 1.0;
+}
+
+/* format the mjd jd as an ISO 8601 UTC date and time, to the second */
+static void
+wf_utc (jd, buf)
+double jd;
+char buf[];
+{
+    double d;
+    long secs;
+    int m, y;
+
+    rnd_second (&jd);
+    mjd_cal (mjd_day(jd), &m, &d, &y);
+    secs = (long)floor (mjd_hr(jd)*3600.0 + 0.5);
+    if (secs > 86399L)
+        secs = 86399L;
+    (void) sprintf (buf, "%04d-%02d-%02dT%02ld:%02ld:%02ldZ", y, m, (int)d,
+                    secs/3600, secs/60%60, secs%60);
+}
+
+/* write the n chars at s as the inside of a JSON string */
+static void
+wf_json (fp, s, n)
+FILE *fp;
+char *s;
+int n;
+{
+    while (--n >= 0)
+    {
+        int c = *s++ & 0xff;
+
+        if (c == '"' || c == '\\')
+            (void) fprintf (fp, "\\%c", c);
+        else if (c == '\r')
+            (void) fputs ("\\r", fp);
+        else if (c == '\n')
+            (void) fputs ("\\n", fp);
+        else if (c < ' ' || c == 0x7f)
+            (void) fprintf (fp, "\\u%04x", c);
+        else
+            (void) putc (c, fp);
+    }
+}
+
 #ifdef GLOBE_PHOON
 /* assimilated ASCII graphic earth and moon from http://acme.com/software/ */
 void putmoon_jd( double jd, int numlines, char* atfiller );
+void putmoon_forget( void );
 void print_globe_jd( double jd );
 time_t julian_to_unix( double jd );
 
@@ -678,7 +1146,7 @@ double tminc;	/* hrs to increment time by each step */
         if (!once)
             slp_sync();
 
-        if (once || (chk_char()==0 && read_char()!=0))
+        if (once || (chk_event()==0 && read_char()!=0))
         {
             if (readwcmd (tminc0, &tminc, &once) < 0)
                 break;
@@ -707,8 +1175,11 @@ double tminc;	/* hrs to increment time by each step */
     while (1)
     {
 
-        if (once)
+        /* after a command anything may have been drawn over the moon */
+        if (once) {
             print_updating();
+            putmoon_forget();
+        }
 
         // draw moon first, then time/date
         double jd = mjd + 2415020L;
@@ -734,7 +1205,7 @@ double tminc;	/* hrs to increment time by each step */
         if (!once)
             slp_sync();
 
-        if (once || (chk_char()==0 && read_char()!=0))
+        if (once || (chk_event()==0 && read_char()!=0))
         {
             if (readwcmd (tminc0, &tminc, &once) < 0)
                 break;
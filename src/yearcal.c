@@ -0,0 +1,371 @@
+/* code to write a calendar for a whole year to a file.
+ * each local day gets its date, day of week, local times of astronomical
+ * dawn and dusk, the length of the dark night and any quarter phase of the
+ * moon. the text form begins with the twelve months at a glance, marked
+ * with the phases as on the screen calendar; the CSV form is one line per
+ * day for loading into something else, and adds nautical and civil dawn
+ * and dusk.
+ * the phases all come from one mph_list() for the year and the twilights
+ * from one twilight_table().
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "astro.h"
+#include "circum.h"
+#include "screen.h"
+#include "ephem.h"
+
+#define	FNLEN		(14+1)	/* longest filename; plus 1 for \0 */
+#define	YC_MAXDAYS	366
+#define	YC_MAXPH	64	/* quarter phases in a year, with room */
+
+#define	YC_TEXT		0	/* output formats */
+#define	YC_CSV		1
+
+typedef struct
+{
+    int d_m, d_d;	/* month 1..12 and day of month */
+    int d_dow;		/* day of week, 0 is Sunday, -1 if unknown */
+    Twilight d_tw;	/* its twilights */
+    int d_ph;		/* quarter phase on this day, 0..3, or -1 */
+    double d_phlt;	/* local hour of the phase */
+} YcDay;
+
+static char yc_filename[FNLEN] = "ephem.cal";
+static char *mnames[] =
+{
+    "January", "February", "March", "April", "May", "June",
+    "July", "August", "September", "October", "November", "December"
+};
+static char *dnames[] = {"Su", "Mo", "Tu", "We", "Th", "Fr", "Sa"};
+static char *phnames[] = {"NM", "FQ", "FM", "LQ"};
+
+static int yc_days (Now *np, int y, YcDay days[]);
+static void yc_hm (char *buf, double hrs);
+static void yc_twi (Twilight *wp, int k, char *dawn, char *dusk, char *night);
+static void yc_text (FILE *fp, Now *np, int y, YcDay days[], int nd);
+static void yc_csv (FILE *fp, int y, YcDay days[], int nd);
+
+/* picked the calendar heading:
+ * ask for the form, year and file name and write the calendar.
+ */
+void yearcal_setup (np)
+Now *np;
+{
+    static char *chcs[] =
+    {
+        "Write year calendar as text", "Write year calendar as CSV"
+    };
+    static int fn;	/* start with 0, then remember for next time */
+    static YcDay days[YC_MAXDAYS];
+    char line[FNLEN], buf[NC];
+    char *optype;
+    FILE *fp;
+    double d;
+    int m, y, nd, fmt, n;
+
+    fmt = popup (chcs, fn, 2);
+    if (fmt < 0)
+        return;
+    fn = fmt;
+
+    /* ask for the year, default the current local one */
+    mjd_cal (mjd_day(np->n_mjd - np->n_tz/24.0), &m, &d, &y);
+    (void) sprintf (buf, "year <%d>: ", y);
+    f_prompt (buf);
+    n = read_line (line, 6);
+    if (n < 0)
+        return;
+    if (n > 0 && (y = atoi (line)) == 0)
+    {
+        f_msg ("There is no year 0.");
+        return;
+    }
+
+    /* prompt for file name, giving current as default */
+    (void) sprintf (buf, "file to write <%s>: ", yc_filename);
+    f_prompt (buf);
+    n = read_line (line, sizeof(line)-1);
+    if (n < 0)
+        return;
+    if (n > 0)
+        (void) strcpy (yc_filename, line);
+
+    /* give option to append if file already exists */
+    optype = "w";
+    if (access (yc_filename, 2) == 0)
+    {
+        while (1)
+        {
+            f_prompt ("file exists; append or overwrite (a/o)?: ");
+            n = read_char();
+            if (n == 'a')
+            {
+                optype = "a";
+                break;
+            }
+            if (n == 'o')
+                break;
+        }
+    }
+
+    fp = fopen (yc_filename, optype);
+    if (!fp)
+    {
+        (void) sprintf (buf, "can't open %s: %s", yc_filename,
+                        strerror(errno));
+        f_msg (buf);
+        return;
+    }
+
+    print_updating();
+    nd = yc_days (np, y, days);
+    if (fmt == YC_CSV)
+        yc_csv (fp, y, days, nd);
+    else
+        yc_text (fp, np, y, days, nd);
+
+    if (ferror (fp))
+    {
+        (void) sprintf (buf, "error writing %s: %s", yc_filename,
+                        strerror(errno));
+        f_msg (buf);
+    }
+    (void) fclose (fp);
+}
+
+/* fill days[] for each local day of year y at np's location.
+ * return the number of days.
+ */
+static int
+yc_days (np, y, days)
+Now *np;
+int y;
+YcDay days[];
+{
+    static Twilight tw[YC_MAXDAYS];
+    Now now;
+    double jan1, nextjan1, start;
+    double ph[YC_MAXPH];
+    int phw[YC_MAXPH];
+    int nd, nph, dow0, dpm;
+    int i, m, d;
+
+    cal_mjd (1, 1.0, y, &jan1);
+    cal_mjd (1, 1.0, y+1, &nextjan1);
+    nd = (int)(nextjan1 - jan1 + 0.5);
+    if (nd > YC_MAXDAYS)
+        nd = YC_MAXDAYS;
+    mjd_dow (jan1, &dow0);
+
+    /* all the twilights, starting from local noon of Jan 1 */
+    now = *np;
+    now.n_mjd = jan1 + 0.5 + now.n_tz/24.0;
+    twilight_table (&now, nd, tw);
+
+    /* walk the days, stepping month and day of week as we go */
+    m = 1;
+    d = 1;
+    mjd_dpm (jan1, &dpm);
+    for (i = 0; i < nd; i++)
+    {
+        YcDay *dp = &days[i];
+
+        if (d > dpm)
+        {
+            m++;
+            d = 1;
+            mjd_dpm (jan1 + i, &dpm);
+        }
+        dp->d_m = m;
+        dp->d_d = d++;
+        dp->d_dow = dow0 < 0 ? -1 : (dow0 + i) % 7;
+
+        dp->d_tw = tw[i];
+        dp->d_ph = -1;
+    }
+
+    /* then mark the phases, all found in one go */
+    start = jan1 + np->n_tz/24.0;	/* local midnight, as UT */
+    nph = mph_list (start, start + nd, ph, phw, YC_MAXPH);
+    for (i = 0; i < nph; i++)
+    {
+        double lt = ph[i] - np->n_tz/24.0 - jan1;	/* local days in */
+        int di = (int)floor(lt);
+
+        if (di >= 0 && di < nd)
+        {
+            days[di].d_ph = phw[i];
+            days[di].d_phlt = (lt - di) * 24.0;
+        }
+    }
+
+    return (nd);
+}
+
+/* format hrs as hh:mm, to the nearest minute */
+static void
+yc_hm (buf, hrs)
+char *buf;
+double hrs;
+{
+    int mins = (int)floor(hrs*60.0 + 0.5);
+
+    mins %= 24*60;
+    if (mins < 0)
+        mins += 24*60;
+    (void) sprintf (buf, "%02d:%02d", mins/60, mins%60);
+}
+
+/* write the year at a glance, three months across, then a line per day */
+static void
+yc_text (fp, np, y, days, nd)
+FILE *fp;
+Now *np;
+int y;
+YcDay days[];
+int nd;
+{
+    char grid[3][8][3*7];	/* 3 months, heading + names + 6 weeks */
+    char dawn[8], dusk[8], night[8], phase[16];
+    int first[13];		/* days[] index of the 1st of each month */
+    int nm;			/* months found; 12 unless calendar reform */
+    int q, i, r, c;
+
+    (void) fprintf (fp, "%d   times are %.3s, %g hours behind UTC\n",
+                    y, np->n_tznm, np->n_tz);
+    (void) fprintf (fp, "latitude %.4f, longitude %.4f (+ west); ",
+                    raddeg(np->n_lat), -raddeg(np->n_lng));
+    (void) fprintf (fp, "twilight is astronomical\n\n");
+
+    for (i = 0, nm = 0; i < nd && nm < 12; i++)
+        if (days[i].d_d == 1)
+            first[nm++] = i;
+    first[nm] = nd;
+
+    for (q = 0; q < 4; q++)
+    {
+        for (c = 0; c < 3; c++)
+        {
+            int mo = q*3 + c;
+            int f;
+
+            (void) memset (grid[c], ' ', sizeof(grid[c]));
+            if (mo >= nm)
+                continue;
+            f = days[first[mo]].d_dow;
+            (void) memcpy (&grid[c][0][(20 - strlen(mnames[mo]))/2],
+                           mnames[mo], strlen(mnames[mo]));
+            (void) memcpy (grid[c][1], "Su Mo Tu We Th Fr Sa", 20);
+            if (f < 0)
+                f = 0;
+            for (i = first[mo]; i < first[mo+1]; i++)
+            {
+                int di = days[i].d_d - 1 + f;
+                char cell[4];
+
+                if (days[i].d_ph == 0 || days[i].d_ph == 2)
+                    (void) strcpy (cell, phnames[days[i].d_ph]);
+                else
+                    (void) sprintf (cell, "%2d", days[i].d_d);
+                (void) memcpy (&grid[c][2+di/7][3*(di%7)], cell, 2);
+            }
+        }
+        for (r = 0; r < 8; r++)
+        {
+            char row[3*22+1];
+            int l;
+
+            for (c = 0; c < 3; c++)
+                (void) sprintf (row+22*c, "%.20s  ", grid[c][r]);
+            for (l = strlen(row); l > 0 && row[l-1] == ' '; --l)
+                continue;
+            row[l] = '\0';
+            (void) fprintf (fp, "%s\n", row);
+        }
+    }
+
+    (void) fprintf (fp, "\nDate    Dy  Dawn   Dusk   Night  Moon\n");
+    for (i = 0; i < nd; i++)
+    {
+        YcDay *dp = &days[i];
+
+        yc_twi (&dp->d_tw, TW_ASTRO, dawn, dusk, night);
+        if (!dawn[0])
+        {
+            (void) strcpy (dawn, "-----");
+            (void) strcpy (dusk, "-----");
+            (void) strcpy (night, "-----");
+        }
+        (void) fprintf (fp, "%.3s %2d  %s  %s  %s  %s",
+                        mnames[dp->d_m-1], dp->d_d,
+                        dp->d_dow < 0 ? "  " : dnames[dp->d_dow],
+                        dawn, dusk, night);
+        if (dp->d_ph >= 0)
+        {
+            yc_hm (phase, dp->d_phlt);
+            (void) fprintf (fp, "  %s %s", phnames[dp->d_ph], phase);
+        }
+        (void) fprintf (fp, "\n");
+    }
+}
+
+/* write one line per day, with a heading line */
+static void
+yc_csv (fp, y, days, nd)
+FILE *fp;
+int y;
+YcDay days[];
+int nd;
+{
+    char dawn[8], dusk[8], night[8], phtime[8];
+    char ndawn[8], ndusk[8], cdawn[8], cdusk[8], x[8];
+    int i;
+
+    (void) fprintf (fp, "date,dow,dawn,dusk,night,phase,phase_time,%s\n",
+                    "naut_dawn,naut_dusk,civil_dawn,civil_dusk");
+    for (i = 0; i < nd; i++)
+    {
+        YcDay *dp = &days[i];
+
+        phtime[0] = '\0';
+        yc_twi (&dp->d_tw, TW_ASTRO, dawn, dusk, night);
+        yc_twi (&dp->d_tw, TW_NAUT, ndawn, ndusk, x);
+        yc_twi (&dp->d_tw, TW_CIVIL, cdawn, cdusk, x);
+        if (dp->d_ph >= 0)
+            yc_hm (phtime, dp->d_phlt);
+        (void) fprintf (fp, "%04d-%02d-%02d,%s,%s,%s,%s,%s,%s,%s,%s,%s,%s\n",
+                        y, dp->d_m, dp->d_d,
+                        dp->d_dow < 0 ? "" : dnames[dp->d_dow],
+                        dawn, dusk, night,
+                        dp->d_ph >= 0 ? phnames[dp->d_ph] : "", phtime,
+                        ndawn, ndusk, cdawn, cdusk);
+    }
+}
+
+/* format twilight k of *wp as hh:mm into dawn and dusk, and the time from
+ * dusk to dawn into night; each is left empty if the times are not good.
+ */
+static void
+yc_twi (wp, k, dawn, dusk, night)
+Twilight *wp;
+int k;
+char *dawn, *dusk, *night;
+{
+    double n;
+
+    dawn[0] = dusk[0] = night[0] = '\0';
+    if (wp->w_status[k] != 0)
+        return;
+    n = wp->w_dawn[k] - wp->w_dusk[k];
+    range (&n, 24.0);
+    yc_hm (dawn, wp->w_dawn[k]);
+    yc_hm (dusk, wp->w_dusk[k]);
+    yc_hm (night, n);
+}